@@ -12,6 +12,9 @@
 #ifndef QAIL_H
 #define QAIL_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -25,6 +28,26 @@ extern "C" {
  */
 char* qail_transpile(const char* qail);
 
+/**
+ * Transpile a batch of QAIL strings in a single call.
+ *
+ * Amortizes the FFI crossing and allocation cost over the whole batch:
+ * all results are written into one packed buffer. For each query the buffer
+ * holds a 4-byte little-endian length followed by that many SQL bytes
+ * (not NUL-terminated). A query that fails to transpile is packed with
+ * length 0; call `qail_last_error` for the first failure.
+ *
+ * @param queries  Array of QAIL query strings (UTF-8)
+ * @param count    Number of queries
+ * @param out_ptr  Receives pointer to the packed result buffer
+ * @param out_len  Receives total buffer length in bytes
+ * @return         0 on success, non-zero on argument errors
+ *
+ * The caller must free the buffer with `qail_free_bytes(out_ptr, out_len)`.
+ */
+int qail_transpile_batch(const char** queries, size_t count,
+                         uint8_t** out_ptr, size_t* out_len);
+
 /**
  * Transpile a QAIL string into SQL using a specific dialect.
  * Supported dialects: "postgres", "mysql", "sqlite", "sqlserver".
@@ -35,6 +58,235 @@ char* qail_transpile(const char* qail);
  */
 char* qail_transpile_with_dialect(const char* qail, const char* dialect);
 
+/**
+ * Options for qail_init. Zeroed fields mean "default".
+ */
+typedef struct qail_init_opts {
+    size_t   cache_max_entries;  /* both non-zero: enable transpile cache */
+    size_t   cache_max_bytes;
+    uint32_t warmup_rounds;      /* eager parse+encode rounds (0 = 1)     */
+    uint32_t reserved;
+} qail_init_opts_t;
+
+/**
+ * Capability report filled by qail_init.
+ */
+typedef struct qail_init_report {
+    const char* version;           /* library version; do NOT free        */
+    uint32_t    dialects;          /* bitmask: 1 postgres, 2 sqlite       */
+    uint8_t     cache_enabled;     /* transpile cache active              */
+    uint8_t     wire_encoder;      /* qail_encode_* family available      */
+    uint8_t     parallel_validate; /* qail_validate_batch parallelizes    */
+    uint8_t     reserved;
+} qail_init_report_t;
+
+/**
+ * Perform all one-time library initialization eagerly.
+ *
+ * Without this, the first call into any QAIL function pays lazy setup
+ * (error storage, cache state, parser tables, first allocator growth) as
+ * a latency outlier — visible as a multi-millisecond first query after a
+ * worker respawns. Call once at worker boot to pay that cost up front.
+ *
+ * @param opts    Options, or NULL for defaults
+ * @param report  Receives a capability report, or NULL if not wanted
+ * @return        0 on success
+ *
+ * Safe to call more than once.
+ */
+int qail_init(const qail_init_opts_t* opts, qail_init_report_t* report);
+
+/**
+ * Statistics for the process-wide transpile result cache.
+ */
+typedef struct qail_cache_stats {
+    uint64_t hits;     /* lookups served from the cache              */
+    uint64_t misses;   /* lookups that fell through to the parser    */
+    size_t   entries;  /* entries currently cached                   */
+    size_t   bytes;    /* approximate bytes held (keys + SQL)        */
+} qail_cache_stats_t;
+
+/**
+ * Hot-path instrumentation counters, aggregated across all threads.
+ *
+ * Filled by `qail_stats`. Counters are fed by the transpile family
+ * (`qail_transpile`, `qail_transpile_with_dialect`, `qail_transpile_d`)
+ * through per-thread relaxed atomics, cheap enough to stay enabled in
+ * production; the library can be built with the `stats` feature off to
+ * compile them out, in which case `enabled` reads 0 and the timing
+ * counters stay at zero.
+ */
+typedef struct qail_stats {
+    uint64_t calls;         /* transpile calls, including failures      */
+    uint64_t parse_ns;      /* cumulative nanoseconds spent parsing     */
+    uint64_t emit_ns;       /* cumulative nanoseconds spent emitting    */
+    uint64_t bytes_alloc;   /* bytes of SQL handed back to callers      */
+    uint64_t cache_hits;    /* transpile-cache hits (see qail_cache_*)  */
+    uint64_t cache_misses;  /* transpile-cache misses                   */
+    uint64_t errors;        /* calls that failed to parse               */
+    uint8_t  enabled;       /* 1 when counters are compiled in          */
+    uint8_t  reserved[7];
+} qail_stats_t;
+
+/**
+ * Read hot-path instrumentation counters into a caller-supplied struct.
+ *
+ * Values are monotonic process-lifetime totals; sample periodically and
+ * diff to derive rates.
+ *
+ * @param out  Struct to fill
+ * @return     0 on success, non-zero if out is NULL
+ */
+int qail_stats(qail_stats_t* out);
+
+/**
+ * Configure the process-wide transpile result cache.
+ *
+ * The cache is OFF by default. Once enabled, `qail_transpile` serves
+ * repeated query strings with a hash lookup and a copy instead of a full
+ * parse and emit. Entries are evicted least-recently-used when either
+ * budget is exceeded.
+ *
+ * @param max_entries  Maximum number of cached queries (0 disables)
+ * @param max_bytes    Maximum bytes held by the cache (0 disables)
+ * @return             0 on success
+ *
+ * Reconfiguring drops all cached entries.
+ */
+int qail_cache_configure(size_t max_entries, size_t max_bytes);
+
+/**
+ * Read transpile-cache statistics into a caller-supplied struct.
+ *
+ * @param out  Struct to fill
+ * @return     0 on success, non-zero if out is NULL
+ */
+int qail_cache_stats(qail_cache_stats_t* out);
+
+/**
+ * Opaque pre-resolved dialect handle.
+ *
+ * Resolve a dialect name once at startup with `qail_dialect_get`, then
+ * pass the handle to `qail_transpile_d` on every call, avoiding the
+ * per-call string comparison of `qail_transpile_with_dialect`.
+ */
+typedef struct qail_dialect qail_dialect_t;
+
+/**
+ * Resolve a dialect name ("postgres", "sqlite") to a stable handle.
+ *
+ * @param name  Dialect name (UTF-8, case-insensitive)
+ * @return      Handle valid for the process lifetime (do NOT free),
+ *              or NULL for unknown names; call `qail_last_error` for details
+ */
+const qail_dialect_t* qail_dialect_get(const char* name);
+
+/**
+ * Transpile a QAIL string into SQL using a pre-resolved dialect handle.
+ *
+ * Returns a pointer to a null-terminated C string containing the SQL.
+ * The caller must free this string using `qail_free`.
+ * Returns NULL on error; call `qail_last_error` for details.
+ */
+char* qail_transpile_d(const char* qail, const qail_dialect_t* dialect);
+
+/**
+ * Transpile QAIL to SQL into a caller-supplied buffer.
+ *
+ * Allocation-free variant of `qail_transpile` for hot paths: the caller
+ * owns (and can reuse) the output buffer, so no malloc/free happens per
+ * call. On success the NUL-terminated SQL is written into `buf`.
+ *
+ * @param qail     QAIL query string (UTF-8)
+ * @param buf      Caller-owned output buffer
+ * @param cap      Capacity of buf in bytes (including room for the NUL)
+ * @param out_len  Receives the SQL length excluding the NUL; written even
+ *                 when the buffer is too small, so the caller can grow
+ *                 the buffer and retry
+ * @return         0 on success; 1 if buf is too small (buf untouched);
+ *                 negative on parse/input errors (see qail_last_error)
+ */
+int qail_transpile_into(const char* qail, char* buf, size_t cap, size_t* out_len);
+
+/**
+ * Transpile QAIL to SQL for a named dialect into a caller-supplied buffer.
+ * Same buffer protocol as `qail_transpile_into`.
+ */
+int qail_transpile_with_dialect_into(const char* qail, const char* dialect,
+                                     char* buf, size_t cap, size_t* out_len);
+
+/**
+ * Parse QAIL and write the AST as JSON into a caller-supplied buffer.
+ * Same buffer protocol as `qail_transpile_into`.
+ */
+int qail_parse_json_into(const char* qail, char* buf, size_t cap, size_t* out_len);
+
+/**
+ * Write the QAIL version string into a caller-supplied buffer.
+ * Same buffer protocol as `qail_transpile_into`.
+ */
+int qail_version_into(char* buf, size_t cap, size_t* out_len);
+
+/**
+ * Opaque compiled-query handle.
+ *
+ * Created by `qail_prepare`, which parses the QAIL text once. Parameters
+ * are bound with the `qail_bind_*` setters and the query is transpiled
+ * repeatedly with `qail_query_transpile`, so the hot path is parameter
+ * substitution and byte emission rather than a full re-parse.
+ */
+typedef struct qail_query qail_query_t;
+
+/**
+ * Parse a QAIL string once into a reusable compiled-query handle.
+ *
+ * @param qail  QAIL query string (UTF-8), may contain $1..$N placeholders
+ * @return      Handle (release with qail_query_free), or NULL on error;
+ *              call `qail_last_error` for details
+ */
+qail_query_t* qail_prepare(const char* qail);
+
+/**
+ * Bind an integer to positional parameter `index` (1-based, matching $1).
+ * Returns 0 on success, non-zero on error.
+ */
+int qail_bind_int(qail_query_t* query, uint32_t index, int64_t value);
+
+/**
+ * Bind a double to positional parameter `index` (1-based).
+ * Returns 0 on success, non-zero on error.
+ */
+int qail_bind_float(qail_query_t* query, uint32_t index, double value);
+
+/**
+ * Bind a UTF-8 string to positional parameter `index` (1-based).
+ * The string is copied; the caller keeps ownership of `value`.
+ * Returns 0 on success, non-zero on error.
+ */
+int qail_bind_text(qail_query_t* query, uint32_t index, const char* value);
+
+/**
+ * Bind NULL to positional parameter `index` (1-based).
+ * Returns 0 on success, non-zero on error.
+ */
+int qail_bind_null(qail_query_t* query, uint32_t index);
+
+/**
+ * Transpile a compiled query with its current parameter bindings.
+ * Parameters without a binding are emitted as $N placeholders.
+ *
+ * Returns a pointer to a null-terminated C string containing the SQL.
+ * The caller must free this string using `qail_free`.
+ * Returns NULL on error; call `qail_last_error` for details.
+ */
+char* qail_query_transpile(const qail_query_t* query);
+
+/**
+ * Free a compiled-query handle returned by `qail_prepare`.
+ * Safe to call with NULL.
+ */
+void qail_query_free(qail_query_t* query);
+
 /**
  * Parse QAIL string and return AST as JSON.
  * 
@@ -43,14 +295,247 @@ char* qail_transpile_with_dialect(const char* qail, const char* dialect);
  */
 char* qail_parse_json(const char* qail);
 
+/**
+ * Parse QAIL and return the AST in the flat QBIN binary layout.
+ *
+ * Unlike `qail_parse_json`, the buffer is traversed in place from C with
+ * no deserialization step. All integers are little-endian. Strings are
+ * referenced as (offset, length) u32 pairs relative to a pool at the end
+ * of the buffer; they are raw UTF-8, not NUL-terminated.
+ *
+ * Layout v1:
+ *
+ *   Header (24 bytes):
+ *     u32 magic      "QBIN" (0x4E494251)
+ *     u16 version    1
+ *     u8  action     Action enum code (0 = get, 1 = set, 2 = del, ...)
+ *     u8  distinct   0 or 1
+ *     u32 pool_off   byte offset of the string pool
+ *     u32 pool_len   string pool length
+ *     u32 table_off  table name (pool-relative)
+ *     u32 table_len
+ *
+ *   Columns:
+ *     u32 count, then count * { u32 off; u32 len; } rendered column text
+ *
+ *   Cages:
+ *     u32 count, then per cage:
+ *       u8  kind       0 filter, 1 payload, 2 sort, 3 limit, 4 offset,
+ *                      5 sample, 6 qualify, 7 partition
+ *       u8  sort_order SortOrder code for sort cages, 0xFF otherwise
+ *       u8  logical_op 0 and, 1 or
+ *       u8  reserved
+ *       u32 cond_count
+ *       u64 arg        limit/offset/sample magnitude, 0 otherwise
+ *     then cond_count fixed 40-byte condition records:
+ *       u32 left_off; u32 left_len;   rendered left-hand expression
+ *       u8  op;                        Operator enum code (0 = eq, ...)
+ *       u8  reserved[7]
+ *       u8  value_tag;                 0 null, 1 bool, 2 int, 3 float,
+ *                                      4 string, 5 param, 6 rendered text
+ *       u8  reserved2[7]
+ *       u64 a;                         int/bool/param value, float bits,
+ *                                      or string pool offset
+ *       u64 b;                         string length, else 0
+ *
+ * @param qail     QAIL query string (UTF-8)
+ * @param out_ptr  Receives pointer to the QBIN buffer
+ * @param out_len  Receives buffer length in bytes
+ * @return         0 on success, non-zero on error (see qail_last_error)
+ *
+ * The caller must free the buffer with `qail_free_bytes(out_ptr, out_len)`.
+ */
+int qail_parse_bin(const char* qail, uint8_t** out_ptr, size_t* out_len);
+
 /**
  * Validate QAIL syntax without transpiling.
- * 
+ *
+ * Malformed input is screened by a vectorized pre-pass (leading-keyword
+ * check plus a SIMD scan for illegal bytes, dispatched across
+ * AVX2/SSE2/NEON at runtime) before the full parser runs, so rejecting
+ * garbage at an API edge costs a few cycles per 16-32 bytes.
+ *
  * @param qail  QAIL query string (UTF-8)
  * @return      1 if valid, 0 if invalid or NULL
  */
 int qail_validate(const char* qail);
 
+/**
+ * Opaque streaming-transpile handle for bulk migration files.
+ *
+ * The stream borrows the caller's input buffer (keep it alive until
+ * qail_stream_free), tokenizes statement boundaries internally —
+ * statements end at a top-level `;` or a blank line, `#` comments run
+ * to end of line, and both are literal inside single-quoted strings —
+ * and reuses one output buffer across statements, so a whole file is
+ * processed in one pass with constant memory.
+ */
+typedef struct QailStream qail_stream_t;
+
+/**
+ * Open a statement stream over a caller-owned buffer.
+ *
+ * @param buf  Input buffer (UTF-8, not necessarily NUL-terminated)
+ * @param len  Input length in bytes
+ * @return     Stream handle, or NULL if buf is NULL
+ *
+ * The caller must free the stream with `qail_stream_free`.
+ */
+qail_stream_t* qail_stream_open(const char* buf, size_t len);
+
+/**
+ * Pull the next transpiled statement.
+ *
+ * @param stream  Stream handle
+ * @param sql     Receives a pointer to the SQL (NUL-terminated; owned by
+ *                the stream and overwritten by the next call)
+ * @param len     Receives the SQL length in bytes
+ * @return        1 when a statement was yielded, 0 at end of input,
+ *                -1 on a parse error (see qail_last_error; the stream
+ *                has advanced past the bad statement, so keep calling
+ *                to skip it or stop to abort)
+ */
+int qail_stream_next(qail_stream_t* stream, const char** sql, size_t* len);
+
+/**
+ * Free a statement stream. The input buffer remains caller-owned.
+ */
+void qail_stream_free(qail_stream_t* stream);
+
+/**
+ * Encode a QAIL GET query directly to PostgreSQL wire-protocol bytes.
+ *
+ * Skips SQL text entirely: the AST is encoded straight into the extended
+ * query protocol messages, so the server pays no parse cost. This is the
+ * same string-free path the PHP extension uses.
+ *
+ * @param table    Table name
+ * @param columns  Comma-separated column list, or "*" for all (NULL = "*")
+ * @param limit    Row limit, or -1 for no limit
+ * @param out_ptr  Receives pointer to the encoded bytes
+ * @param out_len  Receives length of the bytes
+ * @return         0 on success, non-zero on error (see qail_last_error)
+ *
+ * The caller owns the bytes and must release them with
+ * `qail_free_bytes(out_ptr, out_len)`.
+ */
+int qail_encode_get(const char* table, const char* columns, int64_t limit,
+                    uint8_t** out_ptr, size_t* out_len);
+
+/**
+ * Encode a batch of GET queries into one wire-protocol buffer for
+ * pipelined execution (a single round trip).
+ *
+ * @param tables       Array of table names, one per query
+ * @param columns_arr  Array of column specs (comma-separated or "*")
+ * @param limits       Array of row limits (-1 for no limit)
+ * @param count        Number of queries
+ * @param out_ptr      Receives pointer to the encoded bytes
+ * @param out_len      Receives length of the bytes
+ * @return             0 on success, non-zero on error
+ *
+ * The caller must release the bytes with `qail_free_bytes(out_ptr, out_len)`.
+ */
+int qail_encode_batch_get(const char** tables, const char** columns_arr,
+                          const int64_t* limits, size_t count,
+                          uint8_t** out_ptr, size_t* out_len);
+
+/**
+ * Encode a uniform batch of `count` identical GET queries.
+ *
+ * High-throughput pattern: encode once at startup, write the same bytes
+ * to the socket many times with no further FFI calls.
+ *
+ * @param table    Table name
+ * @param columns  Comma-separated column list, or "*" for all (NULL = "*")
+ * @param limit    Row limit, or -1 for no limit
+ * @param count    Number of identical queries in the batch
+ * @param out_ptr  Receives pointer to the encoded bytes
+ * @param out_len  Receives length of the bytes
+ * @return         0 on success, non-zero on error
+ *
+ * The caller must release the bytes with `qail_free_bytes(out_ptr, out_len)`.
+ */
+int qail_encode_uniform_batch(const char* table, const char* columns,
+                              int64_t limit, size_t count,
+                              uint8_t** out_ptr, size_t* out_len);
+
+/**
+ * Opaque bump-allocation arena backing the `_a` result variants.
+ *
+ * Request-scoped workloads make many qail_* calls and then discard every
+ * result at once; the arena turns those individual malloc/free pairs
+ * into pointer bumps plus one `qail_arena_reset` at end of request.
+ * Results are copied into fixed chunks that are never reallocated, so
+ * pointers stay valid until the next reset or free. Not thread-safe:
+ * use one arena per thread (or per request).
+ */
+typedef struct QailArena qail_arena_t;
+
+/**
+ * Create an arena.
+ *
+ * @param reserve  Chunk size in bytes; 0 picks a 64KB default. Results
+ *                 larger than a chunk get a dedicated chunk of their own.
+ * @return         Arena handle (free with qail_arena_free)
+ */
+qail_arena_t* qail_arena_new(size_t reserve);
+
+/**
+ * Invalidate every result allocated from the arena and reuse its memory.
+ * The initial chunk is kept, so resetting between requests settles into
+ * zero allocations at steady state.
+ */
+void qail_arena_reset(qail_arena_t* arena);
+
+/**
+ * Free the arena and every result allocated from it. Safe with NULL.
+ */
+void qail_arena_free(qail_arena_t* arena);
+
+/**
+ * qail_transpile, with the result allocated from `arena`.
+ *
+ * The returned string lives until the arena is reset or freed; never
+ * pass it to qail_free(). Shares the transpile cache with
+ * qail_transpile. Returns NULL on error (check qail_last_error).
+ */
+const char* qail_transpile_a(qail_arena_t* arena, const char* qail);
+
+/**
+ * qail_parse_json, with the JSON string allocated from `arena`.
+ * Same lifetime rules as qail_transpile_a.
+ */
+const char* qail_parse_json_a(qail_arena_t* arena, const char* qail);
+
+/**
+ * qail_encode_get, with the wire bytes allocated from `arena`.
+ *
+ * Returns the bytes directly (length via out_len) rather than an
+ * out-pointer/return-code pair; NULL with *out_len = 0 on error. The
+ * bytes live until the arena is reset or freed; never pass them to
+ * qail_free_bytes().
+ */
+const uint8_t* qail_encode_get_a(qail_arena_t* arena, const char* table,
+                                 const char* columns, int64_t limit,
+                                 size_t* out_len);
+
+/**
+ * Validate a batch of QAIL strings in a single call.
+ *
+ * Writes pass/fail into a caller-owned bitmask: bit i of out_bits is set
+ * when queries[i] is valid (bit i lives in byte i / 8 at position i % 8).
+ * No allocations happen on the result path, and large batches are
+ * validated in parallel inside the library. NULL entries count as invalid.
+ *
+ * @param queries   Array of QAIL query strings (UTF-8)
+ * @param count     Number of queries
+ * @param out_bits  Caller-owned bitmask of at least (count + 7) / 8 bytes;
+ *                  fully overwritten
+ * @return          0 on success, non-zero on argument errors
+ */
+int qail_validate_batch(const char** queries, size_t count, uint8_t* out_bits);
+
 /**
  * Get the last error message.
  * 
@@ -66,6 +551,15 @@ const char* qail_last_error(void);
  */
 void qail_free(char* ptr);
 
+/**
+ * Free a byte buffer returned by QAIL functions.
+ * Safe to call with NULL.
+ *
+ * @param ptr  Pointer to free
+ * @param len  Length that was returned alongside the pointer
+ */
+void qail_free_bytes(uint8_t* ptr, size_t len);
+
 /**
  * Get QAIL library version.
  * 
@@ -0,0 +1,197 @@
+/**
+ * QAIL C++ API - header-only RAII wrapper over the C ABI (qail.h)
+ *
+ * Example:
+ *   #include <qail.hpp>
+ *
+ *   auto sql = qail::transpile<qail::dialect::postgres>("get::users:'_");
+ *   if (sql) use(sql.view());            // string_view, no copy
+ *   else     log(qail::last_error());
+ *
+ * Result types own the library-allocated buffer and release it with the
+ * matching qail_free/qail_free_bytes on destruction. They are move-only:
+ * the buffer has exactly one owner, and `view()` exposes it without
+ * copying. Call `str()` when a detached std::string is actually needed.
+ *
+ * Requires C++17. Link against libqail_ffi as usual; this header adds
+ * no runtime dependency of its own.
+ */
+
+#ifndef QAIL_HPP
+#define QAIL_HPP
+
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "qail.h"
+
+namespace qail {
+
+/** Owning wrapper for a NUL-terminated string returned by the library. */
+class result {
+public:
+    result() noexcept = default;
+
+    /** Takes ownership of `ptr` (may be NULL on error). */
+    explicit result(char* ptr) noexcept
+        : ptr_(ptr), len_(ptr != nullptr ? std::strlen(ptr) : 0) {}
+
+    result(const result&) = delete;
+    result& operator=(const result&) = delete;
+
+    result(result&& other) noexcept
+        : ptr_(std::exchange(other.ptr_, nullptr)),
+          len_(std::exchange(other.len_, 0)) {}
+
+    result& operator=(result&& other) noexcept {
+        if (this != &other) {
+            reset();
+            ptr_ = std::exchange(other.ptr_, nullptr);
+            len_ = std::exchange(other.len_, 0);
+        }
+        return *this;
+    }
+
+    ~result() { reset(); }
+
+    /** True when the call succeeded; check `last_error()` otherwise. */
+    explicit operator bool() const noexcept { return ptr_ != nullptr; }
+
+    /** View over the library-owned buffer. Valid for the lifetime of
+     *  this object; empty on error. */
+    std::string_view view() const noexcept { return {ptr_, len_}; }
+
+    /** Detached copy; empty string on error. */
+    std::string str() const { return std::string(view()); }
+
+    /** The underlying C pointer (NUL-terminated), or nullptr. */
+    const char* c_str() const noexcept { return ptr_; }
+
+private:
+    void reset() noexcept {
+        if (ptr_ != nullptr) qail_free(ptr_);
+        ptr_ = nullptr;
+        len_ = 0;
+    }
+
+    char* ptr_ = nullptr;
+    std::size_t len_ = 0;
+};
+
+/** Owning wrapper for a byte buffer returned by the encode family. */
+class bytes {
+public:
+    bytes() noexcept = default;
+
+    /** Takes ownership of `ptr`/`len` (ptr may be NULL on error). */
+    bytes(uint8_t* ptr, std::size_t len) noexcept : ptr_(ptr), len_(len) {}
+
+    bytes(const bytes&) = delete;
+    bytes& operator=(const bytes&) = delete;
+
+    bytes(bytes&& other) noexcept
+        : ptr_(std::exchange(other.ptr_, nullptr)),
+          len_(std::exchange(other.len_, 0)) {}
+
+    bytes& operator=(bytes&& other) noexcept {
+        if (this != &other) {
+            reset();
+            ptr_ = std::exchange(other.ptr_, nullptr);
+            len_ = std::exchange(other.len_, 0);
+        }
+        return *this;
+    }
+
+    ~bytes() { reset(); }
+
+    explicit operator bool() const noexcept { return ptr_ != nullptr; }
+
+    const uint8_t* data() const noexcept { return ptr_; }
+    std::size_t size() const noexcept { return len_; }
+
+    std::string_view view() const noexcept {
+        return {reinterpret_cast<const char*>(ptr_), len_};
+    }
+
+private:
+    void reset() noexcept {
+        if (ptr_ != nullptr) qail_free_bytes(ptr_, len_);
+        ptr_ = nullptr;
+        len_ = 0;
+    }
+
+    uint8_t* ptr_ = nullptr;
+    std::size_t len_ = 0;
+};
+
+/** Target SQL dialects, selectable at compile time. */
+enum class dialect { postgres, sqlite };
+
+namespace detail {
+
+template <dialect D>
+inline const char* dialect_name() noexcept {
+    if constexpr (D == dialect::postgres) return "postgres";
+    else return "sqlite";
+}
+
+}  // namespace detail
+
+/**
+ * Transpile a QAIL string into SQL for a dialect chosen at compile time.
+ *
+ * The dialect handle is resolved once per instantiation (function-local
+ * static), so every call after the first goes through qail_transpile_d
+ * with no name lookup.
+ */
+template <dialect D = dialect::postgres>
+inline result transpile(const char* query) noexcept {
+    static const qail_dialect_t* handle =
+        qail_dialect_get(detail::dialect_name<D>());
+    return result(qail_transpile_d(query, handle));
+}
+
+template <dialect D = dialect::postgres>
+inline result transpile(const std::string& query) noexcept {
+    return transpile<D>(query.c_str());
+}
+
+/** Parse a QAIL string into its JSON AST representation. */
+inline result parse_json(const char* query) noexcept {
+    return result(qail_parse_json(query));
+}
+
+/** Validate QAIL syntax without transpiling. */
+inline bool validate(const char* query) noexcept {
+    return qail_validate(query) == 1;
+}
+
+/**
+ * Encode a GET query straight to PostgreSQL wire-protocol bytes.
+ * `columns` is a comma-separated list or "*"; `limit` -1 means none.
+ */
+inline bytes encode_get(const char* table, const char* columns = "*",
+                        int64_t limit = -1) noexcept {
+    uint8_t* ptr = nullptr;
+    std::size_t len = 0;
+    if (qail_encode_get(table, columns, limit, &ptr, &len) != 0) {
+        return bytes();
+    }
+    return bytes(ptr, len);
+}
+
+/** Library version string. */
+inline result version() noexcept { return result(qail_version()); }
+
+/** Last error message from this thread, empty when none. The view is
+ *  invalidated by the next `last_error()` call on the same thread. */
+inline std::string_view last_error() noexcept {
+    const char* err = qail_last_error();
+    return err != nullptr ? std::string_view(err) : std::string_view();
+}
+
+}  // namespace qail
+
+#endif /* QAIL_HPP */
@@ -0,0 +1,281 @@
+/**
+ * QAIL IPC - header-only C client for the QAIL daemon
+ *
+ * Talks the daemon's wire protocol (length-prefixed JSON over a Unix
+ * socket, see daemon/src/main.rs) so C consumers can use one warm
+ * daemon process for parsing and PostgreSQL access instead of
+ * statically linking the full Rust library into every worker. This is
+ * the same protocol the Go client in go/go/ipc uses.
+ *
+ * Example:
+ *   #include <qail_ipc.h>
+ *
+ *   qail_ipc_t ipc;
+ *   if (qail_ipc_connect(&ipc, NULL) != 0) die();
+ *   if (qail_ipc_ping(&ipc) != 0) die();
+ *
+ *   size_t len;
+ *   char* json = qail_ipc_get(&ipc, "users", "id,email", NULL, 10, &len);
+ *   ...parse json...
+ *   free(json);
+ *   qail_ipc_close(&ipc);
+ *
+ * All responses are returned as malloc'd JSON strings the caller frees;
+ * parsing is left to whatever JSON library the consumer already has.
+ * Header-only: every function is static, no library to link.
+ */
+
+#ifndef QAIL_IPC_H
+#define QAIL_IPC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define QAIL_IPC_SOCKET_PATH "/tmp/qail.sock"
+#define QAIL_IPC_MAX_MESSAGE (16 * 1024 * 1024) /* daemon MAX_MESSAGE_SIZE */
+
+typedef struct qail_ipc {
+    int fd;
+} qail_ipc_t;
+
+/* ------------------------------------------------------------------ */
+/* Connection                                                          */
+/* ------------------------------------------------------------------ */
+
+/** Connect to the daemon socket (NULL path = /tmp/qail.sock).
+ *  Returns 0 on success, -1 on failure. */
+static inline int qail_ipc_connect(qail_ipc_t* ipc, const char* socket_path) {
+    if (socket_path == NULL) socket_path = QAIL_IPC_SOCKET_PATH;
+
+    ipc->fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (ipc->fd < 0) return -1;
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, socket_path, sizeof(addr.sun_path) - 1);
+
+    if (connect(ipc->fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        close(ipc->fd);
+        ipc->fd = -1;
+        return -1;
+    }
+    return 0;
+}
+
+static inline void qail_ipc_close(qail_ipc_t* ipc) {
+    if (ipc->fd >= 0) {
+        close(ipc->fd);
+        ipc->fd = -1;
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/* Raw request/response                                                */
+/* ------------------------------------------------------------------ */
+
+static inline int qail_ipc_write_all(int fd, const void* buf, size_t len) {
+    const char* p = (const char*)buf;
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n <= 0) return -1;
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static inline int qail_ipc_read_all(int fd, void* buf, size_t len) {
+    char* p = (char*)buf;
+    while (len > 0) {
+        ssize_t n = read(fd, p, len);
+        if (n <= 0) return -1;
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+/** Send one JSON request and receive the JSON response.
+ *  Framing is a 4-byte big-endian length followed by the payload, both
+ *  directions. Returns a malloc'd NUL-terminated response (length in
+ *  *out_len when non-NULL), or NULL on I/O error. */
+static inline char* qail_ipc_request(qail_ipc_t* ipc, const char* json,
+                              size_t json_len, size_t* out_len) {
+    uint8_t header[4] = {
+        (uint8_t)(json_len >> 24), (uint8_t)(json_len >> 16),
+        (uint8_t)(json_len >> 8), (uint8_t)json_len,
+    };
+    if (qail_ipc_write_all(ipc->fd, header, 4) != 0) return NULL;
+    if (qail_ipc_write_all(ipc->fd, json, json_len) != 0) return NULL;
+
+    if (qail_ipc_read_all(ipc->fd, header, 4) != 0) return NULL;
+    size_t resp_len = ((size_t)header[0] << 24) | ((size_t)header[1] << 16) |
+                      ((size_t)header[2] << 8) | (size_t)header[3];
+    if (resp_len > QAIL_IPC_MAX_MESSAGE) return NULL;
+
+    char* resp = (char*)malloc(resp_len + 1);
+    if (resp == NULL) return NULL;
+    if (qail_ipc_read_all(ipc->fd, resp, resp_len) != 0) {
+        free(resp);
+        return NULL;
+    }
+    resp[resp_len] = '\0';
+    if (out_len != NULL) *out_len = resp_len;
+    return resp;
+}
+
+/* ------------------------------------------------------------------ */
+/* JSON building helpers                                               */
+/* ------------------------------------------------------------------ */
+
+/** Append `s` to `buf` as a JSON string literal (quotes and escaping
+ *  included). Returns bytes written, or -1 if `cap` is too small. */
+static inline int qail_ipc_json_string(char* buf, size_t cap, const char* s) {
+    size_t w = 0;
+    if (w + 1 >= cap) return -1;
+    buf[w++] = '"';
+    for (; *s != '\0'; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') {
+            if (w + 2 >= cap) return -1;
+            buf[w++] = '\\';
+            buf[w++] = (char)c;
+        } else if (c < 0x20) {
+            if (w + 6 >= cap) return -1;
+            w += (size_t)snprintf(buf + w, cap - w, "\\u%04x", c);
+        } else {
+            if (w + 1 >= cap) return -1;
+            buf[w++] = (char)c;
+        }
+    }
+    if (w + 2 >= cap) return -1;
+    buf[w++] = '"';
+    buf[w] = '\0';
+    return (int)w;
+}
+
+/** Append `columns` ("a,b,c" or "*" or NULL) as a JSON string array.
+ *  Returns bytes written, or -1 if `cap` is too small. */
+static inline int qail_ipc_json_columns(char* buf, size_t cap, const char* columns) {
+    if (columns == NULL || strcmp(columns, "*") == 0) columns = "*";
+    size_t w = 0;
+    if (w + 1 >= cap) return -1;
+    buf[w++] = '[';
+
+    const char* p = columns;
+    int first = 1;
+    while (*p != '\0') {
+        while (*p == ' ' || *p == ',') p++;
+        if (*p == '\0') break;
+        const char* start = p;
+        while (*p != '\0' && *p != ',') p++;
+        const char* end = p;
+        while (end > start && end[-1] == ' ') end--;
+
+        if (!first) {
+            if (w + 1 >= cap) return -1;
+            buf[w++] = ',';
+        }
+        first = 0;
+
+        char col[256];
+        size_t col_len = (size_t)(end - start);
+        if (col_len >= sizeof(col)) return -1;
+        memcpy(col, start, col_len);
+        col[col_len] = '\0';
+
+        int n = qail_ipc_json_string(buf + w, cap - w, col);
+        if (n < 0) return -1;
+        w += (size_t)n;
+    }
+
+    if (w + 2 >= cap) return -1;
+    buf[w++] = ']';
+    buf[w] = '\0';
+    return (int)w;
+}
+
+/* ------------------------------------------------------------------ */
+/* Typed requests                                                      */
+/* ------------------------------------------------------------------ */
+
+/** Ping the daemon. Returns 0 when it answers Pong, -1 otherwise. */
+static inline int qail_ipc_ping(qail_ipc_t* ipc) {
+    const char* req = "{\"type\":\"Ping\"}";
+    char* resp = qail_ipc_request(ipc, req, strlen(req), NULL);
+    if (resp == NULL) return -1;
+    int ok = strstr(resp, "\"Pong\"") != NULL ? 0 : -1;
+    free(resp);
+    return ok;
+}
+
+/** Ask the daemon to open its PostgreSQL connection.
+ *  `password` may be NULL. Returns 0 on Connected, -1 otherwise. */
+static inline int qail_ipc_db_connect(qail_ipc_t* ipc, const char* host,
+                               uint16_t port, const char* user,
+                               const char* database, const char* password) {
+    char req[1024];
+    char hbuf[256], ubuf[256], dbuf[256], pbuf[256];
+    if (qail_ipc_json_string(hbuf, sizeof(hbuf), host) < 0 ||
+        qail_ipc_json_string(ubuf, sizeof(ubuf), user) < 0 ||
+        qail_ipc_json_string(dbuf, sizeof(dbuf), database) < 0) {
+        return -1;
+    }
+    if (password != NULL &&
+        qail_ipc_json_string(pbuf, sizeof(pbuf), password) < 0) {
+        return -1;
+    }
+
+    int n = snprintf(req, sizeof(req),
+                     "{\"type\":\"Connect\",\"host\":%s,\"port\":%u,"
+                     "\"user\":%s,\"database\":%s,\"password\":%s}",
+                     hbuf, (unsigned)port, ubuf, dbuf,
+                     password != NULL ? pbuf : "null");
+    if (n < 0 || (size_t)n >= sizeof(req)) return -1;
+
+    char* resp = qail_ipc_request(ipc, req, (size_t)n, NULL);
+    if (resp == NULL) return -1;
+    int ok = strstr(resp, "\"Connected\"") != NULL ? 0 : -1;
+    free(resp);
+    return ok;
+}
+
+/** Execute a GET (SELECT) through the daemon.
+ *  `columns` is comma-separated or "*"; `filter` may be NULL; `limit`
+ *  -1 means no limit. Returns the malloc'd response JSON (a Results or
+ *  Error message), or NULL on I/O error. */
+static inline char* qail_ipc_get(qail_ipc_t* ipc, const char* table,
+                          const char* columns, const char* filter,
+                          int64_t limit, size_t* out_len) {
+    char req[4096];
+    char tbuf[256], cbuf[2048], fbuf[1024];
+    if (qail_ipc_json_string(tbuf, sizeof(tbuf), table) < 0 ||
+        qail_ipc_json_columns(cbuf, sizeof(cbuf), columns) < 0) {
+        return NULL;
+    }
+    if (filter != NULL &&
+        qail_ipc_json_string(fbuf, sizeof(fbuf), filter) < 0) {
+        return NULL;
+    }
+
+    char lbuf[32];
+    if (limit >= 0) snprintf(lbuf, sizeof(lbuf), "%lld", (long long)limit);
+    else snprintf(lbuf, sizeof(lbuf), "null");
+
+    int n = snprintf(req, sizeof(req),
+                     "{\"type\":\"Get\",\"table\":%s,\"columns\":%s,"
+                     "\"filter\":%s,\"limit\":%s}",
+                     tbuf, cbuf, filter != NULL ? fbuf : "null", lbuf);
+    if (n < 0 || (size_t)n >= sizeof(req)) return NULL;
+
+    return qail_ipc_request(ipc, req, (size_t)n, out_len);
+}
+
+#endif /* QAIL_IPC_H */
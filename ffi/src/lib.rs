@@ -56,9 +56,26 @@ pub extern "C" fn qail_transpile(qail: *const c_char) -> *mut c_char {
         }
     };
 
+    if let Some(sql) = cache_get(qail_str) {
+        stats_record(0, 0, sql.len() as u64, false);
+        return match CString::new(sql) {
+            Ok(c_string) => c_string.into_raw(),
+            Err(e) => {
+                set_error(format!("NUL byte in output: {}", e));
+                std::ptr::null_mut()
+            }
+        };
+    }
+
+    let parse_start = std::time::Instant::now();
     match qail_core::parse(qail_str) {
         Ok(cmd) => {
+            let parse_ns = parse_start.elapsed().as_nanos() as u64;
+            let emit_start = std::time::Instant::now();
             let sql = cmd.to_sql();
+            let emit_ns = emit_start.elapsed().as_nanos() as u64;
+            stats_record(parse_ns, emit_ns, sql.len() as u64, false);
+            cache_put(qail_str, &sql);
             match CString::new(sql) {
                 Ok(c_string) => c_string.into_raw(),
                 Err(e) => {
@@ -68,12 +85,88 @@ pub extern "C" fn qail_transpile(qail: *const c_char) -> *mut c_char {
             }
         }
         Err(e) => {
+            stats_record(parse_start.elapsed().as_nanos() as u64, 0, 0, true);
             set_error(format!("{:?}", e));
             std::ptr::null_mut()
         }
     }
 }
 
+/// Transpile a batch of QAIL strings in one call.
+/// Results are written into a single packed buffer: for each query a 4-byte
+/// little-endian length followed by that many SQL bytes (not NUL-terminated).
+/// A query that fails to transpile is packed with length 0; the first error
+/// is available via qail_last_error().
+/// Returns 0 on success, non-zero on argument errors.
+/// Caller must free the buffer with qail_free_bytes(out_ptr, out_len).
+#[unsafe(no_mangle)]
+pub extern "C" fn qail_transpile_batch(
+    queries: *const *const c_char,
+    count: usize,
+    out_ptr: *mut *mut u8,
+    out_len: *mut usize,
+) -> i32 {
+    clear_error();
+
+    if queries.is_null() || out_ptr.is_null() || out_len.is_null() || count == 0 {
+        set_error("NULL pointer or zero count".to_string());
+        return -1;
+    }
+
+    let mut packed: Vec<u8> = Vec::with_capacity(count * 64);
+    let mut first_error: Option<String> = None;
+
+    for i in 0..count {
+        let query_ptr = unsafe { *queries.add(i) };
+        if query_ptr.is_null() {
+            set_error(format!("NULL query at index {}", i));
+            return -2;
+        }
+
+        let sql = match unsafe { CStr::from_ptr(query_ptr) }.to_str() {
+            Ok(s) => match qail_core::parse(s) {
+                Ok(cmd) => Some(cmd.to_sql()),
+                Err(e) => {
+                    if first_error.is_none() {
+                        first_error = Some(format!("Query {}: {:?}", i, e));
+                    }
+                    None
+                }
+            },
+            Err(e) => {
+                if first_error.is_none() {
+                    first_error = Some(format!("Query {}: invalid UTF-8: {}", i, e));
+                }
+                None
+            }
+        };
+
+        match sql {
+            Some(sql) => {
+                packed.extend_from_slice(&(sql.len() as u32).to_le_bytes());
+                packed.extend_from_slice(sql.as_bytes());
+            }
+            None => packed.extend_from_slice(&0u32.to_le_bytes()),
+        }
+    }
+
+    if let Some(err) = first_error {
+        set_error(err);
+    }
+
+    let len = packed.len();
+    let mut boxed = packed.into_boxed_slice();
+    let ptr = boxed.as_mut_ptr();
+    std::mem::forget(boxed);
+
+    unsafe {
+        *out_ptr = ptr;
+        *out_len = len;
+    }
+
+    0
+}
+
 #[unsafe(no_mangle)]
 pub extern "C" fn qail_transpile_with_dialect(
     qail: *const c_char,
@@ -117,9 +210,14 @@ pub extern "C" fn qail_transpile_with_dialect(
         }
     };
 
+    let parse_start = std::time::Instant::now();
     match qail_core::parse(qail_str) {
         Ok(cmd) => {
+            let parse_ns = parse_start.elapsed().as_nanos() as u64;
+            let emit_start = std::time::Instant::now();
             let sql = cmd.to_sql_with_dialect(d);
+            let emit_ns = emit_start.elapsed().as_nanos() as u64;
+            stats_record(parse_ns, emit_ns, sql.len() as u64, false);
             match CString::new(sql) {
                 Ok(c_string) => c_string.into_raw(),
                 Err(e) => {
@@ -129,6 +227,7 @@ pub extern "C" fn qail_transpile_with_dialect(
             }
         }
         Err(e) => {
+            stats_record(parse_start.elapsed().as_nanos() as u64, 0, 0, true);
             set_error(format!("{:?}", e));
             std::ptr::null_mut()
         }
@@ -177,6 +276,193 @@ pub extern "C" fn qail_parse_json(qail: *const c_char) -> *mut c_char {
     }
 }
 
+// ============================================================================
+// Binary AST Output (flat, offset-based, zero-copy traversable)
+// ============================================================================
+
+/// Magic bytes "QBIN" (little-endian u32) at the start of every buffer.
+const QBIN_MAGIC: u32 = 0x4E49_4251;
+/// Bump whenever the flat layout changes incompatibly.
+const QBIN_VERSION: u16 = 1;
+
+const QBIN_VALUE_NULL: u8 = 0;
+const QBIN_VALUE_BOOL: u8 = 1;
+const QBIN_VALUE_INT: u8 = 2;
+const QBIN_VALUE_FLOAT: u8 = 3;
+const QBIN_VALUE_STRING: u8 = 4;
+const QBIN_VALUE_PARAM: u8 = 5;
+/// Complex values (subqueries, intervals, expressions) are carried as
+/// their rendered text in layout v1.
+const QBIN_VALUE_TEXT: u8 = 6;
+
+/// Accumulates the flat body and the trailing string pool.
+/// String references are (pool-relative offset, length) u32 pairs, so the
+/// pool can be appended after the body without patching.
+struct QbinWriter {
+    body: Vec<u8>,
+    pool: Vec<u8>,
+}
+
+impl QbinWriter {
+    fn new() -> Self {
+        QbinWriter {
+            body: Vec::with_capacity(256),
+            pool: Vec::with_capacity(256),
+        }
+    }
+
+    fn intern(&mut self, s: &str) -> (u32, u32) {
+        let off = self.pool.len() as u32;
+        self.pool.extend_from_slice(s.as_bytes());
+        (off, s.len() as u32)
+    }
+
+    fn put_u32(&mut self, v: u32) {
+        self.body.extend_from_slice(&v.to_le_bytes());
+    }
+
+    fn put_u64(&mut self, v: u64) {
+        self.body.extend_from_slice(&v.to_le_bytes());
+    }
+
+    fn put_str(&mut self, s: &str) {
+        let (off, len) = self.intern(s);
+        self.put_u32(off);
+        self.put_u32(len);
+    }
+
+    fn put_value(&mut self, value: &Value) {
+        use std::fmt::Write as _;
+        let (tag, a, b) = match value {
+            Value::Null => (QBIN_VALUE_NULL, 0u64, 0u64),
+            Value::Bool(v) => (QBIN_VALUE_BOOL, *v as u64, 0),
+            Value::Int(v) => (QBIN_VALUE_INT, *v as u64, 0),
+            Value::Float(v) => (QBIN_VALUE_FLOAT, v.to_bits(), 0),
+            Value::String(s) => {
+                let (off, len) = self.intern(s);
+                (QBIN_VALUE_STRING, off as u64, len as u64)
+            }
+            Value::Param(n) => (QBIN_VALUE_PARAM, *n as u64, 0),
+            other => {
+                let mut text = String::new();
+                let _ = write!(text, "{}", other);
+                let (off, len) = self.intern(&text);
+                (QBIN_VALUE_TEXT, off as u64, len as u64)
+            }
+        };
+        self.body
+            .extend_from_slice(&[tag, 0, 0, 0, 0, 0, 0, 0]);
+        self.put_u64(a);
+        self.put_u64(b);
+    }
+}
+
+fn encode_qbin(cmd: &Qail) -> Vec<u8> {
+    use qail_core::ast::CageKind;
+
+    let mut w = QbinWriter::new();
+
+    // Table reference is interned first so it sits at pool offset 0.
+    let (table_off, table_len) = w.intern(&cmd.table);
+
+    // Columns: count, then (off, len) of each rendered expression.
+    w.put_u32(cmd.columns.len() as u32);
+    for col in &cmd.columns {
+        let text = col.to_string();
+        w.put_str(&text);
+    }
+
+    // Cages: count, then per cage a fixed header and fixed-size conditions.
+    w.put_u32(cmd.cages.len() as u32);
+    for cage in &cmd.cages {
+        let (kind, sort_order, arg): (u8, u8, u64) = match &cage.kind {
+            CageKind::Filter => (0, 0xFF, 0),
+            CageKind::Payload => (1, 0xFF, 0),
+            CageKind::Sort(order) => (2, *order as u8, 0),
+            CageKind::Limit(n) => (3, 0xFF, *n as u64),
+            CageKind::Offset(n) => (4, 0xFF, *n as u64),
+            CageKind::Sample(n) => (5, 0xFF, *n as u64),
+            CageKind::Qualify => (6, 0xFF, 0),
+            CageKind::Partition => (7, 0xFF, 0),
+        };
+        w.body
+            .extend_from_slice(&[kind, sort_order, cage.logical_op as u8, 0]);
+        w.put_u32(cage.conditions.len() as u32);
+        w.put_u64(arg);
+
+        for cond in &cage.conditions {
+            let left = cond.left.to_string();
+            w.put_str(&left);
+            w.body
+                .extend_from_slice(&[cond.op as u8, 0, 0, 0, 0, 0, 0, 0]);
+            w.put_value(&cond.value);
+        }
+    }
+
+    // Assemble: 24-byte header, body, string pool.
+    let pool_off = 24 + w.body.len();
+    let mut buf = Vec::with_capacity(pool_off + w.pool.len());
+    buf.extend_from_slice(&QBIN_MAGIC.to_le_bytes());
+    buf.extend_from_slice(&QBIN_VERSION.to_le_bytes());
+    buf.push(cmd.action as u8);
+    buf.push(cmd.distinct as u8);
+    buf.extend_from_slice(&(pool_off as u32).to_le_bytes());
+    buf.extend_from_slice(&(w.pool.len() as u32).to_le_bytes());
+    buf.extend_from_slice(&table_off.to_le_bytes());
+    buf.extend_from_slice(&table_len.to_le_bytes());
+    buf.extend_from_slice(&w.body);
+    buf.extend_from_slice(&w.pool);
+    buf
+}
+
+/// Parse QAIL and return the AST in the flat QBIN binary layout.
+/// Unlike qail_parse_json, the result needs no deserialization: C code
+/// walks the buffer in place (see the layout notes in qail.h).
+/// Returns 0 on success, non-zero on error.
+/// Caller must free the bytes with qail_free_bytes(out_ptr, out_len).
+#[unsafe(no_mangle)]
+pub extern "C" fn qail_parse_bin(
+    qail: *const c_char,
+    out_ptr: *mut *mut u8,
+    out_len: *mut usize,
+) -> i32 {
+    clear_error();
+
+    if qail.is_null() || out_ptr.is_null() || out_len.is_null() {
+        set_error("NULL pointer argument".to_string());
+        return -1;
+    }
+
+    let qail_str = match unsafe { CStr::from_ptr(qail) }.to_str() {
+        Ok(s) => s,
+        Err(e) => {
+            set_error(format!("Invalid UTF-8: {}", e));
+            return -2;
+        }
+    };
+
+    let cmd = match qail_core::parse(qail_str) {
+        Ok(cmd) => cmd,
+        Err(e) => {
+            set_error(format!("{:?}", e));
+            return -3;
+        }
+    };
+
+    let buf = encode_qbin(&cmd);
+    let len = buf.len();
+    let mut boxed = buf.into_boxed_slice();
+    let ptr = boxed.as_mut_ptr();
+    std::mem::forget(boxed);
+
+    unsafe {
+        *out_ptr = ptr;
+        *out_len = len;
+    }
+
+    0
+}
+
 /// Validate QAIL syntax.
 /// Returns 1 if valid, 0 if invalid.
 #[unsafe(no_mangle)]
@@ -188,7 +474,7 @@ pub extern "C" fn qail_validate(qail: *const c_char) -> i32 {
     let c_str = unsafe { CStr::from_ptr(qail) };
     match c_str.to_str() {
         Ok(s) => {
-            if qail_core::parse(s).is_ok() {
+            if validate_prepass(s) && qail_core::parse(s).is_ok() {
                 1
             } else {
                 0
@@ -198,47 +484,1308 @@ pub extern "C" fn qail_validate(qail: *const c_char) -> i32 {
     }
 }
 
-/// Get the last error message.
-/// Returns NULL if no error.
-/// The returned string is valid until the next QAIL function call.
+// ============================================================================
+// Streaming Transpile (bulk migration files, one pass, O(1) memory)
+// ============================================================================
+
+/// Streaming transpiler state exposed to C as `qail_stream_t*`.
+/// Borrows the caller's input buffer and owns one output buffer that is
+/// reused for every statement, so memory stays constant regardless of
+/// how many statements the file contains.
+pub struct QailStream {
+    input: *const u8,
+    len: usize,
+    pos: usize,
+    /// Reused statement buffer: the next statement's bytes, comments
+    /// stripped, collected here on each `qail_stream_next`.
+    stmt: Vec<u8>,
+    /// Reused SQL output: cleared and refilled on each `qail_stream_next`,
+    /// always NUL-terminated for C convenience.
+    out: Vec<u8>,
+}
+
+/// Collect the next statement's bytes into `stmt` (cleared first),
+/// starting at `pos`. Statements end at a top-level `;`, a blank line
+/// (a line holding only whitespace or a comment also counts), or end of
+/// input; `#` starts a comment running to end of line. Separators and
+/// comment markers inside single-quoted literals are literal text.
+/// Returns the position to resume from; `stmt` may come back empty when
+/// only whitespace and comments remained.
+fn stream_collect(input: &[u8], mut pos: usize, stmt: &mut Vec<u8>) -> usize {
+    stmt.clear();
+    let mut in_quote = false;
+    let mut in_comment = false;
+    let mut newline_run = 0u32;
+
+    while pos < input.len() {
+        let b = input[pos];
+        if in_comment {
+            if b == b'\n' {
+                in_comment = false;
+                newline_run += 1;
+                if newline_run >= 2 && !stmt.is_empty() {
+                    return pos + 1;
+                }
+                if !stmt.is_empty() {
+                    stmt.push(b);
+                }
+            }
+            pos += 1;
+            continue;
+        }
+        match b {
+            b'\'' => {
+                in_quote = !in_quote;
+                newline_run = 0;
+                stmt.push(b);
+            }
+            b';' if !in_quote => return pos + 1,
+            b'#' if !in_quote => in_comment = true,
+            b'\n' if !in_quote => {
+                newline_run += 1;
+                if newline_run >= 2 && !stmt.is_empty() {
+                    return pos + 1;
+                }
+                if !stmt.is_empty() {
+                    stmt.push(b);
+                }
+            }
+            b' ' | b'\t' | b'\r' if !in_quote => {
+                if !stmt.is_empty() {
+                    stmt.push(b);
+                }
+            }
+            _ => {
+                newline_run = 0;
+                stmt.push(b);
+            }
+        }
+        pos += 1;
+    }
+    input.len()
+}
+
+/// Open a statement stream over a caller-owned buffer.
+/// The buffer must stay valid until qail_stream_free; the library does
+/// not copy it. Returns NULL if buf is NULL.
+/// Caller must free the stream with qail_stream_free().
+#[unsafe(no_mangle)]
+pub extern "C" fn qail_stream_open(buf: *const c_char, len: usize) -> *mut QailStream {
+    clear_error();
+
+    if buf.is_null() {
+        set_error("NULL input buffer".to_string());
+        return std::ptr::null_mut();
+    }
+
+    Box::into_raw(Box::new(QailStream {
+        input: buf as *const u8,
+        len,
+        pos: 0,
+        stmt: Vec::with_capacity(256),
+        out: Vec::with_capacity(256),
+    }))
+}
+
+/// Pull the next transpiled statement from the stream.
+///
+/// On success writes a pointer to the SQL (NUL-terminated, owned by the
+/// stream and overwritten by the next call) and its length, and returns 1.
+/// Returns 0 at end of input, -1 on a parse error (see qail_last_error);
+/// after an error the stream has advanced past the bad statement, so the
+/// caller may keep pulling to skip it or stop and report.
+#[unsafe(no_mangle)]
+pub extern "C" fn qail_stream_next(
+    stream: *mut QailStream,
+    sql: *mut *const c_char,
+    len: *mut usize,
+) -> i32 {
+    clear_error();
+
+    if stream.is_null() || sql.is_null() || len.is_null() {
+        set_error("NULL pointer".to_string());
+        return -2;
+    }
+    let s = unsafe { &mut *stream };
+    let input = unsafe { std::slice::from_raw_parts(s.input, s.len) };
+
+    loop {
+        if s.pos >= s.len {
+            return 0;
+        }
+        let offset = s.pos;
+        let mut stmt_buf = std::mem::take(&mut s.stmt);
+        s.pos = stream_collect(input, s.pos, &mut stmt_buf);
+        s.stmt = stmt_buf;
+
+        let stmt = match std::str::from_utf8(&s.stmt) {
+            Ok(t) => t.trim(),
+            Err(e) => {
+                set_error(format!("Invalid UTF-8 at offset {}: {}", offset, e));
+                return -1;
+            }
+        };
+        if stmt.is_empty() {
+            continue;
+        }
+
+        match qail_core::parse(stmt) {
+            Ok(cmd) => {
+                let rendered = cmd.to_sql();
+                s.out.clear();
+                s.out.extend_from_slice(rendered.as_bytes());
+                s.out.push(0);
+                unsafe {
+                    *sql = s.out.as_ptr() as *const c_char;
+                    *len = s.out.len() - 1;
+                }
+                return 1;
+            }
+            Err(e) => {
+                set_error(format!("At offset {}: {:?}", offset, e));
+                return -1;
+            }
+        }
+    }
+}
+
+/// Free a statement stream. The input buffer remains caller-owned.
+#[unsafe(no_mangle)]
+pub extern "C" fn qail_stream_free(stream: *mut QailStream) {
+    if !stream.is_null() {
+        unsafe {
+            drop(Box::from_raw(stream));
+        }
+    }
+}
+
+// ============================================================================
+// Validation Fast Pre-Pass (vectorized byte scan + leading-keyword check)
+// ============================================================================
+
+/// Leading keywords accepted by the grammar entry points in
+/// core/src/parser/grammar: parse_txn_command, parse_create_index, the
+/// WITH clause, and parse_action. Must stay in sync — the pre-pass may
+/// only reject input the full parser would also reject.
+const VALIDATE_KEYWORDS: [&str; 13] = [
+    "get", "set", "delete", "del", "insert", "add", "create", "make", "index",
+    "begin", "commit", "rollback", "with",
+];
+
+fn prepass_keyword_ok(trimmed: &str) -> bool {
+    let bytes = trimmed.as_bytes();
+    VALIDATE_KEYWORDS.iter().any(|k| {
+        bytes.len() >= k.len() && bytes[..k.len()].eq_ignore_ascii_case(k.as_bytes())
+    })
+}
+
+/// Scalar byte classifier; also finishes the vectorized tails.
+/// Returns (has_quote, has_illegal) where illegal means a control byte
+/// other than tab/newline/carriage-return.
+fn scan_scalar(bytes: &[u8]) -> (bool, bool) {
+    let mut has_quote = false;
+    let mut has_illegal = false;
+    for &b in bytes {
+        has_quote |= b == b'\'';
+        has_illegal |= b < 0x20 && b != b'\t' && b != b'\n' && b != b'\r';
+    }
+    (has_quote, has_illegal)
+}
+
+#[cfg(target_arch = "x86_64")]
+#[target_feature(enable = "avx2")]
+unsafe fn scan_avx2(bytes: &[u8]) -> (bool, bool) {
+    use std::arch::x86_64::*;
+
+    let quote = _mm256_set1_epi8(b'\'' as i8);
+    let ctrl_max = _mm256_set1_epi8(0x1f);
+    let tab = _mm256_set1_epi8(b'\t' as i8);
+    let nl = _mm256_set1_epi8(b'\n' as i8);
+    let cr = _mm256_set1_epi8(b'\r' as i8);
+
+    let mut acc_quote = _mm256_setzero_si256();
+    let mut acc_illegal = _mm256_setzero_si256();
+
+    let mut i = 0;
+    while i + 32 <= bytes.len() {
+        let v = unsafe { _mm256_loadu_si256(bytes.as_ptr().add(i) as *const __m256i) };
+        acc_quote = _mm256_or_si256(acc_quote, _mm256_cmpeq_epi8(v, quote));
+
+        // v <= 0x1f (unsigned) exactly when min(v, 0x1f) == v
+        let is_ctrl = _mm256_cmpeq_epi8(_mm256_min_epu8(v, ctrl_max), v);
+        let is_ws = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, tab), _mm256_cmpeq_epi8(v, nl)),
+            _mm256_cmpeq_epi8(v, cr),
+        );
+        acc_illegal = _mm256_or_si256(acc_illegal, _mm256_andnot_si256(is_ws, is_ctrl));
+        i += 32;
+    }
+
+    let (tail_quote, tail_illegal) = scan_scalar(&bytes[i..]);
+    (
+        _mm256_movemask_epi8(acc_quote) != 0 || tail_quote,
+        _mm256_movemask_epi8(acc_illegal) != 0 || tail_illegal,
+    )
+}
+
+#[cfg(target_arch = "x86_64")]
+#[target_feature(enable = "sse2")]
+unsafe fn scan_sse2(bytes: &[u8]) -> (bool, bool) {
+    use std::arch::x86_64::*;
+
+    let quote = _mm_set1_epi8(b'\'' as i8);
+    let ctrl_max = _mm_set1_epi8(0x1f);
+    let tab = _mm_set1_epi8(b'\t' as i8);
+    let nl = _mm_set1_epi8(b'\n' as i8);
+    let cr = _mm_set1_epi8(b'\r' as i8);
+
+    let mut acc_quote = _mm_setzero_si128();
+    let mut acc_illegal = _mm_setzero_si128();
+
+    let mut i = 0;
+    while i + 16 <= bytes.len() {
+        let v = unsafe { _mm_loadu_si128(bytes.as_ptr().add(i) as *const __m128i) };
+        acc_quote = _mm_or_si128(acc_quote, _mm_cmpeq_epi8(v, quote));
+
+        let is_ctrl = _mm_cmpeq_epi8(_mm_min_epu8(v, ctrl_max), v);
+        let is_ws = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(v, tab), _mm_cmpeq_epi8(v, nl)),
+            _mm_cmpeq_epi8(v, cr),
+        );
+        acc_illegal = _mm_or_si128(acc_illegal, _mm_andnot_si128(is_ws, is_ctrl));
+        i += 16;
+    }
+
+    let (tail_quote, tail_illegal) = scan_scalar(&bytes[i..]);
+    (
+        _mm_movemask_epi8(acc_quote) != 0 || tail_quote,
+        _mm_movemask_epi8(acc_illegal) != 0 || tail_illegal,
+    )
+}
+
+#[cfg(target_arch = "aarch64")]
+unsafe fn scan_neon(bytes: &[u8]) -> (bool, bool) {
+    use std::arch::aarch64::*;
+
+    let quote = unsafe { vdupq_n_u8(b'\'') };
+    let ctrl_max = unsafe { vdupq_n_u8(0x1f) };
+    let tab = unsafe { vdupq_n_u8(b'\t') };
+    let nl = unsafe { vdupq_n_u8(b'\n') };
+    let cr = unsafe { vdupq_n_u8(b'\r') };
+
+    let mut acc_quote = unsafe { vdupq_n_u8(0) };
+    let mut acc_illegal = unsafe { vdupq_n_u8(0) };
+
+    let mut i = 0;
+    while i + 16 <= bytes.len() {
+        unsafe {
+            let v = vld1q_u8(bytes.as_ptr().add(i));
+            acc_quote = vorrq_u8(acc_quote, vceqq_u8(v, quote));
+
+            let is_ctrl = vcleq_u8(v, ctrl_max);
+            let is_ws = vorrq_u8(vorrq_u8(vceqq_u8(v, tab), vceqq_u8(v, nl)), vceqq_u8(v, cr));
+            acc_illegal = vorrq_u8(acc_illegal, vbicq_u8(is_ctrl, is_ws));
+        }
+        i += 16;
+    }
+
+    let (tail_quote, tail_illegal) = scan_scalar(&bytes[i..]);
+    unsafe {
+        (
+            vmaxvq_u8(acc_quote) != 0 || tail_quote,
+            vmaxvq_u8(acc_illegal) != 0 || tail_illegal,
+        )
+    }
+}
+
+/// Dispatch the byte scan to the widest unit the CPU supports.
+fn scan_bytes(bytes: &[u8]) -> (bool, bool) {
+    #[cfg(target_arch = "x86_64")]
+    {
+        if std::arch::is_x86_feature_detected!("avx2") {
+            unsafe { scan_avx2(bytes) }
+        } else {
+            // SSE2 is part of the x86_64 baseline
+            unsafe { scan_sse2(bytes) }
+        }
+    }
+    #[cfg(target_arch = "aarch64")]
+    {
+        unsafe { scan_neon(bytes) }
+    }
+    #[cfg(not(any(target_arch = "x86_64", target_arch = "aarch64")))]
+    {
+        scan_scalar(bytes)
+    }
+}
+
+/// Cheap structural screen run before the full parser: rejects input
+/// whose leading keyword no grammar entry point accepts, and input
+/// containing control bytes when no quoted literal could be hiding them
+/// (quoted strings may legally contain any byte, so the byte check only
+/// applies to quote-free input). Conservative by construction — anything
+/// that passes still goes through the real parser.
+fn validate_prepass(s: &str) -> bool {
+    let trimmed = s.trim();
+    if trimmed.is_empty() || !prepass_keyword_ok(trimmed) {
+        return false;
+    }
+    let (has_quote, has_illegal) = scan_bytes(trimmed.as_bytes());
+    !(has_illegal && !has_quote)
+}
+
+/// Validation threshold below which batches stay on the calling thread;
+/// thread spawn cost only pays for itself on large lints.
+const VALIDATE_PARALLEL_THRESHOLD: usize = 256;
+
+fn validate_one(query: *const c_char) -> bool {
+    if query.is_null() {
+        return false;
+    }
+    match unsafe { CStr::from_ptr(query) }.to_str() {
+        Ok(s) => validate_prepass(s) && qail_core::parse(s).is_ok(),
+        Err(_) => false,
+    }
+}
+
+/// Validate each byte-range of the batch into a packed bitmask byte slice.
+/// `start` is the index of the first query covered by `bits[0]` bit 0.
+fn validate_range(queries: &[*const c_char], start: usize, bits: &mut [u8]) {
+    for (i, &query) in queries.iter().enumerate() {
+        if validate_one(query) {
+            let idx = start + i;
+            bits[(idx - start) / 8] |= 1 << (idx % 8);
+        }
+    }
+}
+
+/// Validate a batch of QAIL strings in one call, writing pass/fail into a
+/// caller-owned bitmask (bit i of out_bits set = queries[i] is valid).
+/// out_bits must hold at least (count + 7) / 8 bytes; it is fully
+/// overwritten. Large batches are validated in parallel across threads.
+/// NULL entries validate as invalid.
+/// Returns 0 on success, non-zero on argument errors.
+#[unsafe(no_mangle)]
+pub extern "C" fn qail_validate_batch(
+    queries: *const *const c_char,
+    count: usize,
+    out_bits: *mut u8,
+) -> i32 {
+    if queries.is_null() || out_bits.is_null() || count == 0 {
+        return -1;
+    }
+
+    let queries = unsafe { std::slice::from_raw_parts(queries, count) };
+    let n_bytes = count.div_ceil(8);
+    let bits = unsafe { std::slice::from_raw_parts_mut(out_bits, n_bytes) };
+    bits.fill(0);
+
+    if count < VALIDATE_PARALLEL_THRESHOLD {
+        validate_range(queries, 0, bits);
+        return 0;
+    }
+
+    let workers = std::thread::available_parallelism()
+        .map(|n| n.get())
+        .unwrap_or(1)
+        .min(n_bytes);
+
+    // Chunk at byte boundaries of the bitmask so each worker owns a
+    // disjoint byte range and no atomic bit updates are needed.
+    let bytes_per_worker = n_bytes.div_ceil(workers);
+    std::thread::scope(|scope| {
+        // SAFETY across threads: raw pointers are Send-wrapped per chunk;
+        // the C caller guarantees the string array outlives this call.
+        struct SendPtrs<'a>(&'a [*const c_char]);
+        unsafe impl Send for SendPtrs<'_> {}
+
+        for (chunk_idx, bits_chunk) in bits.chunks_mut(bytes_per_worker).enumerate() {
+            let start = chunk_idx * bytes_per_worker * 8;
+            let end = (start + bits_chunk.len() * 8).min(count);
+            let chunk = SendPtrs(&queries[start..end]);
+            scope.spawn(move || {
+                let chunk = chunk;
+                validate_range(chunk.0, start, bits_chunk);
+            });
+        }
+    });
+
+    0
+}
+
+/// Get the last error message.
+/// Returns NULL if no error.
+/// The returned string is valid until the next QAIL function call.
+#[unsafe(no_mangle)]
+pub extern "C" fn qail_last_error() -> *const c_char {
+    thread_local! {
+        static ERROR_CSTRING: RefCell<Option<CString>> = const { RefCell::new(None) };
+    }
+
+    LAST_ERROR.with(|e| {
+        let error = e.borrow();
+        match &*error {
+            Some(msg) => ERROR_CSTRING.with(|ec| {
+                let c_str = CString::new(msg.clone()).unwrap_or_default();
+                let ptr = c_str.as_ptr();
+                *ec.borrow_mut() = Some(c_str);
+                ptr
+            }),
+            None => std::ptr::null(),
+        }
+    })
+}
+
+/// Free a string returned by QAIL functions.
+/// Safe to call with NULL.
+#[unsafe(no_mangle)]
+pub extern "C" fn qail_free(ptr: *mut c_char) {
+    if !ptr.is_null() {
+        unsafe {
+            drop(CString::from_raw(ptr));
+        }
+    }
+}
+
+/// Free bytes returned by qail_encode_* functions.
+/// Safe to call with NULL.
+#[unsafe(no_mangle)]
+pub extern "C" fn qail_free_bytes(ptr: *mut u8, len: usize) {
+    if !ptr.is_null() && len > 0 {
+        unsafe {
+            let _ = Vec::from_raw_parts(ptr, len, len);
+        }
+    }
+}
+
+// ============================================================================
+// Explicit Initialization (pay one-time costs at startup, not first call)
+// ============================================================================
+
+/// Initialization options, mirrored by qail_init_opts_t in qail.h.
+/// Zeroed fields mean "default".
+#[repr(C)]
+pub struct QailInitOpts {
+    /// Transpile-cache budgets; both non-zero enables the cache
+    /// (equivalent to calling qail_cache_configure).
+    pub cache_max_entries: usize,
+    pub cache_max_bytes: usize,
+    /// Number of warmup parse+transpile rounds to run eagerly (0 = 1).
+    pub warmup_rounds: u32,
+    pub reserved: u32,
+}
+
+/// Capability report, mirrored by qail_init_report_t in qail.h.
+#[repr(C)]
+pub struct QailInitReport {
+    /// Library version; static storage, do NOT free.
+    pub version: *const c_char,
+    /// Bitmask of available dialects: 1 = postgres, 2 = sqlite.
+    pub dialects: u32,
+    /// 1 if the transpile result cache is enabled.
+    pub cache_enabled: u8,
+    /// 1 if the wire-protocol encoder (qail_encode_*) is available.
+    pub wire_encoder: u8,
+    /// 1 if qail_validate_batch parallelizes large batches.
+    pub parallel_validate: u8,
+    pub reserved: u8,
+}
+
+/// Perform all one-time initialization eagerly.
+/// Safe to call more than once; later calls only re-run the warmup (and
+/// reconfigure the cache if the options ask for it). Without this, the
+/// first call into the library pays lazy setup (error storage, cache
+/// state, parser tables) as a latency outlier.
+/// Returns 0 on success.
+#[unsafe(no_mangle)]
+pub extern "C" fn qail_init(opts: *const QailInitOpts, report: *mut QailInitReport) -> i32 {
+    clear_error(); // also faults in the thread-local error slot
+
+    let (cache_entries, cache_bytes, warmup_rounds) = if opts.is_null() {
+        (0, 0, 1)
+    } else {
+        let opts = unsafe { &*opts };
+        (
+            opts.cache_max_entries,
+            opts.cache_max_bytes,
+            opts.warmup_rounds.max(1),
+        )
+    };
+
+    if cache_entries > 0 && cache_bytes > 0 {
+        qail_cache_configure(cache_entries, cache_bytes);
+    } else {
+        // Still force the lazy cache state into existence.
+        TRANSPILE_CACHE.enabled.load(Ordering::Relaxed);
+    }
+
+    // Warmup: exercise the parser and both emit paths so their one-time
+    // setup and the allocator's first growth happen now.
+    for _ in 0..warmup_rounds {
+        if let Ok(cmd) = qail_core::parse("get __qail_warmup fields id where id = $1") {
+            let _ = cmd.to_sql();
+            let _ = AstEncoder::encode_cmd(&cmd);
+        }
+    }
+
+    if !report.is_null() {
+        static VERSION: &str = concat!(env!("CARGO_PKG_VERSION"), "\0");
+        unsafe {
+            (*report).version = VERSION.as_ptr() as *const c_char;
+            (*report).dialects = 0b11;
+            (*report).cache_enabled = TRANSPILE_CACHE.enabled.load(Ordering::Relaxed) as u8;
+            (*report).wire_encoder = 1;
+            (*report).parallel_validate = 1;
+            (*report).reserved = 0;
+        }
+    }
+
+    0
+}
+
+// ============================================================================
+// Transpile Result Cache (opt-in, shard-locked LRU)
+// ============================================================================
+
+use std::collections::HashMap;
+use std::hash::{Hash, Hasher};
+use std::sync::Mutex;
+use std::sync::atomic::{AtomicBool, AtomicU64, AtomicUsize, Ordering};
+
+const CACHE_SHARDS: usize = 16;
+
+struct CacheEntry {
+    qail: String,
+    sql: String,
+    last_used: u64,
+}
+
+struct CacheShard {
+    map: HashMap<u64, CacheEntry>,
+}
+
+struct TranspileCache {
+    shards: [Mutex<CacheShard>; CACHE_SHARDS],
+    enabled: AtomicBool,
+    max_entries: AtomicUsize,
+    max_bytes: AtomicUsize,
+    entries: AtomicUsize,
+    bytes: AtomicUsize,
+    hits: AtomicU64,
+    misses: AtomicU64,
+    clock: AtomicU64,
+}
+
+static TRANSPILE_CACHE: std::sync::LazyLock<TranspileCache> =
+    std::sync::LazyLock::new(|| TranspileCache {
+        shards: std::array::from_fn(|_| {
+            Mutex::new(CacheShard {
+                map: HashMap::new(),
+            })
+        }),
+        enabled: AtomicBool::new(false),
+        max_entries: AtomicUsize::new(0),
+        max_bytes: AtomicUsize::new(0),
+        entries: AtomicUsize::new(0),
+        bytes: AtomicUsize::new(0),
+        hits: AtomicU64::new(0),
+        misses: AtomicU64::new(0),
+        clock: AtomicU64::new(0),
+    });
+
+fn cache_key(qail: &str) -> u64 {
+    let mut hasher = std::collections::hash_map::DefaultHasher::new();
+    qail.hash(&mut hasher);
+    hasher.finish()
+}
+
+/// Look up a transpiled result. Costs a hash, one shard lock, and the
+/// copy into the returned String.
+fn cache_get(qail: &str) -> Option<String> {
+    if !TRANSPILE_CACHE.enabled.load(Ordering::Relaxed) {
+        return None;
+    }
+
+    let key = cache_key(qail);
+    let shard = &TRANSPILE_CACHE.shards[key as usize % CACHE_SHARDS];
+    let mut shard = shard.lock().unwrap_or_else(|e| e.into_inner());
+
+    if let Some(entry) = shard.map.get_mut(&key) {
+        if entry.qail == qail {
+            entry.last_used = TRANSPILE_CACHE.clock.fetch_add(1, Ordering::Relaxed);
+            TRANSPILE_CACHE.hits.fetch_add(1, Ordering::Relaxed);
+            return Some(entry.sql.clone());
+        }
+    }
+
+    TRANSPILE_CACHE.misses.fetch_add(1, Ordering::Relaxed);
+    None
+}
+
+fn cache_put(qail: &str, sql: &str) {
+    if !TRANSPILE_CACHE.enabled.load(Ordering::Relaxed) {
+        return;
+    }
+
+    let entry_bytes = qail.len() + sql.len();
+    let max_entries = TRANSPILE_CACHE.max_entries.load(Ordering::Relaxed);
+    let max_bytes = TRANSPILE_CACHE.max_bytes.load(Ordering::Relaxed);
+    if entry_bytes > max_bytes {
+        return;
+    }
+
+    let key = cache_key(qail);
+    let shard = &TRANSPILE_CACHE.shards[key as usize % CACHE_SHARDS];
+    let mut shard = shard.lock().unwrap_or_else(|e| e.into_inner());
+
+    if shard.map.contains_key(&key) {
+        return;
+    }
+
+    // Evict least-recently-used entries in this shard until the new entry
+    // fits both global budgets. Shards hold at most a few hundred entries
+    // for realistic configurations, so a linear scan is fine.
+    while TRANSPILE_CACHE.entries.load(Ordering::Relaxed) >= max_entries
+        || TRANSPILE_CACHE.bytes.load(Ordering::Relaxed) + entry_bytes > max_bytes
+    {
+        let lru_key = shard
+            .map
+            .iter()
+            .min_by_key(|(_, e)| e.last_used)
+            .map(|(k, _)| *k);
+        match lru_key {
+            Some(k) => {
+                if let Some(evicted) = shard.map.remove(&k) {
+                    TRANSPILE_CACHE.entries.fetch_sub(1, Ordering::Relaxed);
+                    TRANSPILE_CACHE
+                        .bytes
+                        .fetch_sub(evicted.qail.len() + evicted.sql.len(), Ordering::Relaxed);
+                }
+            }
+            // Shard is empty; other shards hold the budget. Skip the insert
+            // rather than evicting across shards (and their locks).
+            None => return,
+        }
+    }
+
+    shard.map.insert(
+        key,
+        CacheEntry {
+            qail: qail.to_string(),
+            sql: sql.to_string(),
+            last_used: TRANSPILE_CACHE.clock.fetch_add(1, Ordering::Relaxed),
+        },
+    );
+    TRANSPILE_CACHE.entries.fetch_add(1, Ordering::Relaxed);
+    TRANSPILE_CACHE.bytes.fetch_add(entry_bytes, Ordering::Relaxed);
+}
+
+/// Cache statistics, mirrored by qail_cache_stats_t in qail.h.
+#[repr(C)]
+pub struct QailCacheStats {
+    pub hits: u64,
+    pub misses: u64,
+    pub entries: usize,
+    pub bytes: usize,
+}
+
+/// Configure the process-wide transpile result cache.
+/// The cache is disabled by default; configuring non-zero limits enables
+/// it for qail_transpile. Configuring with zero for either limit disables
+/// the cache and drops all entries.
+/// Returns 0 on success.
+#[unsafe(no_mangle)]
+pub extern "C" fn qail_cache_configure(max_entries: usize, max_bytes: usize) -> i32 {
+    let enable = max_entries > 0 && max_bytes > 0;
+
+    TRANSPILE_CACHE.enabled.store(false, Ordering::Relaxed);
+    for shard in &TRANSPILE_CACHE.shards {
+        shard.lock().unwrap_or_else(|e| e.into_inner()).map.clear();
+    }
+    TRANSPILE_CACHE.entries.store(0, Ordering::Relaxed);
+    TRANSPILE_CACHE.bytes.store(0, Ordering::Relaxed);
+    TRANSPILE_CACHE.max_entries.store(max_entries, Ordering::Relaxed);
+    TRANSPILE_CACHE.max_bytes.store(max_bytes, Ordering::Relaxed);
+    TRANSPILE_CACHE.enabled.store(enable, Ordering::Relaxed);
+
+    0
+}
+
+/// Read cache statistics into a caller-supplied struct.
+/// Returns 0 on success, non-zero if out is NULL.
+#[unsafe(no_mangle)]
+pub extern "C" fn qail_cache_stats(out: *mut QailCacheStats) -> i32 {
+    if out.is_null() {
+        return -1;
+    }
+    unsafe {
+        (*out).hits = TRANSPILE_CACHE.hits.load(Ordering::Relaxed);
+        (*out).misses = TRANSPILE_CACHE.misses.load(Ordering::Relaxed);
+        (*out).entries = TRANSPILE_CACHE.entries.load(Ordering::Relaxed);
+        (*out).bytes = TRANSPILE_CACHE.bytes.load(Ordering::Relaxed);
+    }
+    0
+}
+
+// ============================================================================
+// Hot-Path Instrumentation Counters (compile out with --no-default-features)
+// ============================================================================
+
+/// Per-thread counters behind the `stats` feature. Every thread that
+/// touches the transpile hot path lazily registers its own counter block
+/// in a global list, so hot-path updates are uncontended relaxed
+/// fetch_adds on thread-private cache lines — cheap enough to leave on
+/// in production. `qail_stats` sums across the list; blocks from dead
+/// threads stay registered so totals remain monotonic.
+#[cfg(feature = "stats")]
+mod stats {
+    use std::sync::atomic::{AtomicU64, Ordering};
+    use std::sync::{Arc, Mutex, OnceLock};
+
+    #[derive(Default)]
+    pub struct ThreadCounters {
+        pub calls: AtomicU64,
+        pub parse_ns: AtomicU64,
+        pub emit_ns: AtomicU64,
+        pub bytes_alloc: AtomicU64,
+        pub errors: AtomicU64,
+    }
+
+    fn registry() -> &'static Mutex<Vec<Arc<ThreadCounters>>> {
+        static REGISTRY: OnceLock<Mutex<Vec<Arc<ThreadCounters>>>> = OnceLock::new();
+        REGISTRY.get_or_init(|| Mutex::new(Vec::new()))
+    }
+
+    thread_local! {
+        static LOCAL: Arc<ThreadCounters> = {
+            let counters = Arc::new(ThreadCounters::default());
+            registry().lock().unwrap().push(counters.clone());
+            counters
+        };
+    }
+
+    pub fn with<F: FnOnce(&ThreadCounters)>(f: F) {
+        LOCAL.with(|c| f(c));
+    }
+
+    /// (calls, parse_ns, emit_ns, bytes_alloc, errors) summed over all
+    /// threads that ever recorded.
+    pub fn aggregate() -> (u64, u64, u64, u64, u64) {
+        let mut totals = (0u64, 0u64, 0u64, 0u64, 0u64);
+        for c in registry().lock().unwrap().iter() {
+            totals.0 += c.calls.load(Ordering::Relaxed);
+            totals.1 += c.parse_ns.load(Ordering::Relaxed);
+            totals.2 += c.emit_ns.load(Ordering::Relaxed);
+            totals.3 += c.bytes_alloc.load(Ordering::Relaxed);
+            totals.4 += c.errors.load(Ordering::Relaxed);
+        }
+        totals
+    }
+}
+
+#[cfg(feature = "stats")]
+#[inline]
+fn stats_record(parse_ns: u64, emit_ns: u64, bytes: u64, error: bool) {
+    stats::with(|c| {
+        c.calls.fetch_add(1, Ordering::Relaxed);
+        c.parse_ns.fetch_add(parse_ns, Ordering::Relaxed);
+        c.emit_ns.fetch_add(emit_ns, Ordering::Relaxed);
+        c.bytes_alloc.fetch_add(bytes, Ordering::Relaxed);
+        if error {
+            c.errors.fetch_add(1, Ordering::Relaxed);
+        }
+    });
+}
+
+#[cfg(not(feature = "stats"))]
+#[inline(always)]
+fn stats_record(_parse_ns: u64, _emit_ns: u64, _bytes: u64, _error: bool) {}
+
+/// Snapshot of hot-path counters exposed to C as `qail_stats_t`.
+#[repr(C)]
+#[derive(Clone, Copy)]
+pub struct QailStats {
+    pub calls: u64,
+    pub parse_ns: u64,
+    pub emit_ns: u64,
+    pub bytes_alloc: u64,
+    pub cache_hits: u64,
+    pub cache_misses: u64,
+    pub errors: u64,
+    pub enabled: u8,
+    pub reserved: [u8; 7],
+}
+
+/// Read hot-path instrumentation counters into a caller-supplied struct.
+/// Returns 0 on success, non-zero if out is NULL.
+#[unsafe(no_mangle)]
+pub extern "C" fn qail_stats(out: *mut QailStats) -> i32 {
+    if out.is_null() {
+        return -1;
+    }
+
+    #[cfg(feature = "stats")]
+    let (calls, parse_ns, emit_ns, bytes_alloc, errors) = stats::aggregate();
+    #[cfg(not(feature = "stats"))]
+    let (calls, parse_ns, emit_ns, bytes_alloc, errors) = (0u64, 0u64, 0u64, 0u64, 0u64);
+
+    unsafe {
+        (*out).calls = calls;
+        (*out).parse_ns = parse_ns;
+        (*out).emit_ns = emit_ns;
+        (*out).bytes_alloc = bytes_alloc;
+        (*out).cache_hits = TRANSPILE_CACHE.hits.load(Ordering::Relaxed);
+        (*out).cache_misses = TRANSPILE_CACHE.misses.load(Ordering::Relaxed);
+        (*out).errors = errors;
+        (*out).enabled = cfg!(feature = "stats") as u8;
+        (*out).reserved = [0; 7];
+    }
+    0
+}
+
+// ============================================================================
+// Pre-Resolved Dialect Handles
+// ============================================================================
+
+/// Opaque dialect handle exposed to C as `qail_dialect_t*`.
+/// Handles are static library-owned singletons: resolve once at startup,
+/// pass the pointer on every call, never free.
+pub struct QailDialect {
+    dialect: Dialect,
+}
+
+static DIALECT_POSTGRES: QailDialect = QailDialect {
+    dialect: Dialect::Postgres,
+};
+static DIALECT_SQLITE: QailDialect = QailDialect {
+    dialect: Dialect::SQLite,
+};
+
+/// Resolve a dialect name to a stable handle.
+/// Returns NULL for unknown names (check qail_last_error).
+/// The handle is library-owned and valid for the process lifetime.
+#[unsafe(no_mangle)]
+pub extern "C" fn qail_dialect_get(name: *const c_char) -> *const QailDialect {
+    clear_error();
+
+    if name.is_null() {
+        set_error("NULL dialect name".to_string());
+        return std::ptr::null();
+    }
+
+    let name_str = match unsafe { CStr::from_ptr(name) }.to_str() {
+        Ok(s) => s,
+        Err(e) => {
+            set_error(format!("Invalid UTF-8 in dialect name: {}", e));
+            return std::ptr::null();
+        }
+    };
+
+    match name_str.to_lowercase().as_str() {
+        "postgres" | "postgresql" => &DIALECT_POSTGRES,
+        "sqlite" => &DIALECT_SQLITE,
+        _ => {
+            set_error(format!("Unsupported dialect: {}", name_str));
+            std::ptr::null()
+        }
+    }
+}
+
+/// Transpile QAIL to SQL using a pre-resolved dialect handle.
+/// The hot-path variant of qail_transpile_with_dialect: no per-call
+/// dialect string comparison or lookup.
+/// Returns NULL on error; caller must free the result with qail_free().
+#[unsafe(no_mangle)]
+pub extern "C" fn qail_transpile_d(
+    qail: *const c_char,
+    dialect: *const QailDialect,
+) -> *mut c_char {
+    clear_error();
+
+    if qail.is_null() {
+        set_error("NULL QAIL input".to_string());
+        return std::ptr::null_mut();
+    }
+    if dialect.is_null() {
+        set_error("NULL dialect handle".to_string());
+        return std::ptr::null_mut();
+    }
+
+    let qail_str = match unsafe { CStr::from_ptr(qail) }.to_str() {
+        Ok(s) => s,
+        Err(e) => {
+            set_error(format!("Invalid UTF-8 in qail string: {}", e));
+            return std::ptr::null_mut();
+        }
+    };
+
+    let d = unsafe { &*dialect }.dialect;
+
+    let parse_start = std::time::Instant::now();
+    match qail_core::parse(qail_str) {
+        Ok(cmd) => {
+            let parse_ns = parse_start.elapsed().as_nanos() as u64;
+            let emit_start = std::time::Instant::now();
+            let sql = cmd.to_sql_with_dialect(d);
+            let emit_ns = emit_start.elapsed().as_nanos() as u64;
+            stats_record(parse_ns, emit_ns, sql.len() as u64, false);
+            match CString::new(sql) {
+                Ok(c_string) => c_string.into_raw(),
+                Err(e) => {
+                    set_error(format!("NUL byte in output: {}", e));
+                    std::ptr::null_mut()
+                }
+            }
+        }
+        Err(e) => {
+            stats_record(parse_start.elapsed().as_nanos() as u64, 0, 0, true);
+            set_error(format!("{:?}", e));
+            std::ptr::null_mut()
+        }
+    }
+}
+
+// ============================================================================
+// Caller-Supplied Output Buffers (allocation-free hot path)
+// ============================================================================
+
+/// Copy `s` into a caller-supplied buffer, NUL-terminated.
+/// Writes the string length (excluding NUL) to out_len in all cases so a
+/// caller whose buffer was too small knows how much to allocate.
+/// Returns 0 on success, 1 if the buffer cannot hold the string plus NUL.
+fn write_into(s: &str, buf: *mut c_char, cap: usize, out_len: *mut usize) -> i32 {
+    if !out_len.is_null() {
+        unsafe {
+            *out_len = s.len();
+        }
+    }
+
+    if buf.is_null() || cap < s.len() + 1 {
+        return 1;
+    }
+
+    unsafe {
+        std::ptr::copy_nonoverlapping(s.as_ptr(), buf as *mut u8, s.len());
+        *buf.add(s.len()) = 0;
+    }
+    0
+}
+
+/// Transpile QAIL to SQL into a caller-supplied buffer (no allocation).
+/// On success writes the NUL-terminated SQL into buf and returns 0.
+/// If the buffer is too small, returns 1 and leaves buf untouched;
+/// out_len receives the required length (excluding NUL) either way.
+/// Returns a negative code on parse/input errors (check qail_last_error).
+#[unsafe(no_mangle)]
+pub extern "C" fn qail_transpile_into(
+    qail: *const c_char,
+    buf: *mut c_char,
+    cap: usize,
+    out_len: *mut usize,
+) -> i32 {
+    clear_error();
+
+    if qail.is_null() {
+        set_error("NULL input".to_string());
+        return -1;
+    }
+
+    let qail_str = match unsafe { CStr::from_ptr(qail) }.to_str() {
+        Ok(s) => s,
+        Err(e) => {
+            set_error(format!("Invalid UTF-8: {}", e));
+            return -2;
+        }
+    };
+
+    match qail_core::parse(qail_str) {
+        Ok(cmd) => write_into(&cmd.to_sql(), buf, cap, out_len),
+        Err(e) => {
+            set_error(format!("{:?}", e));
+            -3
+        }
+    }
+}
+
+/// Transpile QAIL to SQL for a named dialect into a caller-supplied buffer.
+/// Same buffer protocol as qail_transpile_into.
+#[unsafe(no_mangle)]
+pub extern "C" fn qail_transpile_with_dialect_into(
+    qail: *const c_char,
+    dialect: *const c_char,
+    buf: *mut c_char,
+    cap: usize,
+    out_len: *mut usize,
+) -> i32 {
+    clear_error();
+
+    if qail.is_null() || dialect.is_null() {
+        set_error("NULL input".to_string());
+        return -1;
+    }
+
+    let qail_str = match unsafe { CStr::from_ptr(qail) }.to_str() {
+        Ok(s) => s,
+        Err(e) => {
+            set_error(format!("Invalid UTF-8 in qail string: {}", e));
+            return -2;
+        }
+    };
+
+    let dialect_str = match unsafe { CStr::from_ptr(dialect) }.to_str() {
+        Ok(s) => s,
+        Err(e) => {
+            set_error(format!("Invalid UTF-8 in dialect string: {}", e));
+            return -2;
+        }
+    };
+
+    let d = match dialect_str.to_lowercase().as_str() {
+        "postgres" | "postgresql" => Dialect::Postgres,
+        _ => {
+            set_error(format!(
+                "Unsupported dialect: {}. Only 'postgres' is supported.",
+                dialect_str
+            ));
+            return -4;
+        }
+    };
+
+    match qail_core::parse(qail_str) {
+        Ok(cmd) => write_into(&cmd.to_sql_with_dialect(d), buf, cap, out_len),
+        Err(e) => {
+            set_error(format!("{:?}", e));
+            -3
+        }
+    }
+}
+
+/// Parse QAIL and write the AST as JSON into a caller-supplied buffer.
+/// Same buffer protocol as qail_transpile_into.
+#[unsafe(no_mangle)]
+pub extern "C" fn qail_parse_json_into(
+    qail: *const c_char,
+    buf: *mut c_char,
+    cap: usize,
+    out_len: *mut usize,
+) -> i32 {
+    clear_error();
+
+    if qail.is_null() {
+        set_error("NULL input".to_string());
+        return -1;
+    }
+
+    let qail_str = match unsafe { CStr::from_ptr(qail) }.to_str() {
+        Ok(s) => s,
+        Err(e) => {
+            set_error(format!("Invalid UTF-8: {}", e));
+            return -2;
+        }
+    };
+
+    match qail_core::parse(qail_str) {
+        Ok(cmd) => match serde_json::to_string(&cmd) {
+            Ok(json) => write_into(&json, buf, cap, out_len),
+            Err(e) => {
+                set_error(format!("JSON serialization error: {}", e));
+                -3
+            }
+        },
+        Err(e) => {
+            set_error(format!("{:?}", e));
+            -3
+        }
+    }
+}
+
+/// Write the QAIL version string into a caller-supplied buffer.
+/// Same buffer protocol as qail_transpile_into.
+#[unsafe(no_mangle)]
+pub extern "C" fn qail_version_into(buf: *mut c_char, cap: usize, out_len: *mut usize) -> i32 {
+    write_into(env!("CARGO_PKG_VERSION"), buf, cap, out_len)
+}
+
+// ============================================================================
+// Compiled Query Handles (parse once, transpile many)
+// ============================================================================
+
+use qail_core::ast::{Qail, Value};
+
+/// Opaque compiled-query handle exposed to C as `qail_query_t*`.
+/// Holds the parsed AST plus the current parameter bindings so the hot
+/// path is substitution + emission, never re-parsing.
+pub struct QailQuery {
+    cmd: Qail,
+    binds: Vec<Option<Value>>,
+}
+
+fn substitute_value(value: &mut Value, binds: &[Option<Value>]) {
+    match value {
+        Value::Param(n) => {
+            if *n >= 1 {
+                if let Some(Some(bound)) = binds.get(*n - 1) {
+                    *value = bound.clone();
+                }
+            }
+        }
+        Value::Array(items) => {
+            for item in items {
+                substitute_value(item, binds);
+            }
+        }
+        Value::Subquery(sub) => substitute_cmd(sub, binds),
+        _ => {}
+    }
+}
+
+fn substitute_cmd(cmd: &mut Qail, binds: &[Option<Value>]) {
+    for cage in &mut cmd.cages {
+        for cond in &mut cage.conditions {
+            substitute_value(&mut cond.value, binds);
+        }
+    }
+    for cond in &mut cmd.having {
+        substitute_value(&mut cond.value, binds);
+    }
+    for (_, sub) in &mut cmd.set_ops {
+        substitute_cmd(sub, binds);
+    }
+    if let Some(sub) = &mut cmd.source_query {
+        substitute_cmd(sub, binds);
+    }
+    for cte in &mut cmd.ctes {
+        substitute_cmd(&mut cte.base_query, binds);
+        if let Some(sub) = &mut cte.recursive_query {
+            substitute_cmd(sub, binds);
+        }
+    }
+}
+
+fn query_bind(query: *mut QailQuery, index: u32, value: Value) -> i32 {
+    if query.is_null() || index == 0 {
+        set_error("NULL query handle or zero parameter index".to_string());
+        return -1;
+    }
+    let query = unsafe { &mut *query };
+    let slot = index as usize - 1;
+    if query.binds.len() <= slot {
+        query.binds.resize(slot + 1, None);
+    }
+    query.binds[slot] = Some(value);
+    0
+}
+
+/// Parse a QAIL string once and return an opaque compiled-query handle.
+/// Bind parameters with qail_bind_*, then transpile repeatedly with
+/// qail_query_transpile. Returns NULL on error (check qail_last_error).
+/// The handle must be released with qail_query_free().
+#[unsafe(no_mangle)]
+pub extern "C" fn qail_prepare(qail: *const c_char) -> *mut QailQuery {
+    clear_error();
+
+    if qail.is_null() {
+        set_error("NULL input".to_string());
+        return std::ptr::null_mut();
+    }
+
+    let qail_str = match unsafe { CStr::from_ptr(qail) }.to_str() {
+        Ok(s) => s,
+        Err(e) => {
+            set_error(format!("Invalid UTF-8: {}", e));
+            return std::ptr::null_mut();
+        }
+    };
+
+    match qail_core::parse(qail_str) {
+        Ok(cmd) => Box::into_raw(Box::new(QailQuery {
+            cmd,
+            binds: Vec::new(),
+        })),
+        Err(e) => {
+            set_error(format!("{:?}", e));
+            std::ptr::null_mut()
+        }
+    }
+}
+
+/// Bind an integer to positional parameter `index` (1-based, matching $1).
+/// Returns 0 on success, non-zero on error.
+#[unsafe(no_mangle)]
+pub extern "C" fn qail_bind_int(query: *mut QailQuery, index: u32, value: i64) -> i32 {
+    query_bind(query, index, Value::Int(value))
+}
+
+/// Bind a double to positional parameter `index` (1-based).
+/// Returns 0 on success, non-zero on error.
+#[unsafe(no_mangle)]
+pub extern "C" fn qail_bind_float(query: *mut QailQuery, index: u32, value: f64) -> i32 {
+    query_bind(query, index, Value::Float(value))
+}
+
+/// Bind a UTF-8 string to positional parameter `index` (1-based).
+/// The string is copied; the caller keeps ownership of `value`.
+/// Returns 0 on success, non-zero on error.
+#[unsafe(no_mangle)]
+pub extern "C" fn qail_bind_text(query: *mut QailQuery, index: u32, value: *const c_char) -> i32 {
+    if value.is_null() {
+        set_error("NULL value".to_string());
+        return -1;
+    }
+    let text = match unsafe { CStr::from_ptr(value) }.to_str() {
+        Ok(s) => s.to_string(),
+        Err(e) => {
+            set_error(format!("Invalid UTF-8: {}", e));
+            return -2;
+        }
+    };
+    query_bind(query, index, Value::String(text))
+}
+
+/// Bind NULL to positional parameter `index` (1-based).
+/// Returns 0 on success, non-zero on error.
+#[unsafe(no_mangle)]
+pub extern "C" fn qail_bind_null(query: *mut QailQuery, index: u32) -> i32 {
+    query_bind(query, index, Value::Null)
+}
+
+/// Transpile a compiled query with its current parameter bindings.
+/// Parameters without a binding are emitted as $N placeholders.
+/// Returns NULL on error; caller must free the result with qail_free().
 #[unsafe(no_mangle)]
-pub extern "C" fn qail_last_error() -> *const c_char {
-    thread_local! {
-        static ERROR_CSTRING: RefCell<Option<CString>> = const { RefCell::new(None) };
+pub extern "C" fn qail_query_transpile(query: *const QailQuery) -> *mut c_char {
+    clear_error();
+
+    if query.is_null() {
+        set_error("NULL query handle".to_string());
+        return std::ptr::null_mut();
     }
 
-    LAST_ERROR.with(|e| {
-        let error = e.borrow();
-        match &*error {
-            Some(msg) => ERROR_CSTRING.with(|ec| {
-                let c_str = CString::new(msg.clone()).unwrap_or_default();
-                let ptr = c_str.as_ptr();
-                *ec.borrow_mut() = Some(c_str);
-                ptr
-            }),
-            None => std::ptr::null(),
-        }
-    })
-}
+    let query = unsafe { &*query };
+    let sql = if query.binds.is_empty() {
+        query.cmd.to_sql()
+    } else {
+        let mut cmd = query.cmd.clone();
+        substitute_cmd(&mut cmd, &query.binds);
+        cmd.to_sql()
+    };
 
-/// Free a string returned by QAIL functions.
-/// Safe to call with NULL.
-#[unsafe(no_mangle)]
-pub extern "C" fn qail_free(ptr: *mut c_char) {
-    if !ptr.is_null() {
-        unsafe {
-            drop(CString::from_raw(ptr));
+    match CString::new(sql) {
+        Ok(c_string) => c_string.into_raw(),
+        Err(e) => {
+            set_error(format!("NUL byte in output: {}", e));
+            std::ptr::null_mut()
         }
     }
 }
 
-/// Free bytes returned by qail_encode_* functions.
+/// Free a compiled-query handle returned by qail_prepare.
 /// Safe to call with NULL.
 #[unsafe(no_mangle)]
-pub extern "C" fn qail_free_bytes(ptr: *mut u8, len: usize) {
-    if !ptr.is_null() && len > 0 {
+pub extern "C" fn qail_query_free(query: *mut QailQuery) {
+    if !query.is_null() {
         unsafe {
-            let _ = Vec::from_raw_parts(ptr, len, len);
+            drop(Box::from_raw(query));
         }
     }
 }
@@ -533,6 +2080,255 @@ pub extern "C" fn qail_encode_uniform_batch(
     0
 }
 
+// ============================================================================
+// Arena-Scoped Results (one reset per request instead of N qail_free calls)
+// ============================================================================
+
+/// Default chunk size when qail_arena_new is called with reserve = 0.
+const ARENA_DEFAULT_CHUNK: usize = 64 * 1024;
+
+/// Bump allocator backing the `_a` result variants.
+///
+/// Results are copied into fixed-capacity chunks that are never
+/// reallocated, so every pointer handed out stays valid until the next
+/// `qail_arena_reset` / `qail_arena_free`. A reset keeps the first chunk
+/// and drops the overflow chunks, so a warmed arena serves a steady-state
+/// request with zero allocations. Arenas are not thread-safe: use one per
+/// thread (or per request), like the results themselves.
+pub struct QailArena {
+    chunks: Vec<Vec<u8>>,
+    chunk_size: usize,
+}
+
+impl QailArena {
+    fn with_reserve(reserve: usize) -> Self {
+        let chunk_size = if reserve == 0 {
+            ARENA_DEFAULT_CHUNK
+        } else {
+            reserve
+        };
+        QailArena {
+            chunks: vec![Vec::with_capacity(chunk_size)],
+            chunk_size,
+        }
+    }
+
+    /// Copy `data` (plus a NUL terminator when `nul` is set) into the
+    /// arena and return a pointer to the copy.
+    fn alloc(&mut self, data: &[u8], nul: bool) -> *mut u8 {
+        let need = data.len() + usize::from(nul);
+        let fits = self
+            .chunks
+            .last()
+            .is_some_and(|c| c.capacity() - c.len() >= need);
+        if !fits {
+            self.chunks.push(Vec::with_capacity(need.max(self.chunk_size)));
+        }
+        let chunk = self.chunks.last_mut().expect("arena has a chunk");
+        let offset = chunk.len();
+        chunk.extend_from_slice(data);
+        if nul {
+            chunk.push(0);
+        }
+        unsafe { chunk.as_mut_ptr().add(offset) }
+    }
+
+    fn reset(&mut self) {
+        self.chunks.truncate(1);
+        if let Some(chunk) = self.chunks.first_mut() {
+            chunk.clear();
+        }
+    }
+}
+
+/// Create an arena for the `_a` result variants. `reserve` is the chunk
+/// size in bytes (0 picks a 64KB default); results larger than a chunk
+/// get a dedicated chunk of their own.
+/// Free with qail_arena_free(); never qail_free() individual results.
+#[unsafe(no_mangle)]
+pub extern "C" fn qail_arena_new(reserve: usize) -> *mut QailArena {
+    Box::into_raw(Box::new(QailArena::with_reserve(reserve)))
+}
+
+/// Invalidate every result allocated from the arena and make its memory
+/// available for reuse. Overflow chunks are released; the initial chunk
+/// is kept, so resetting between requests settles into zero allocations.
+#[unsafe(no_mangle)]
+pub extern "C" fn qail_arena_reset(arena: *mut QailArena) {
+    if let Some(arena) = unsafe { arena.as_mut() } {
+        arena.reset();
+    }
+}
+
+/// Free the arena and every result allocated from it.
+/// Safe to call with NULL.
+#[unsafe(no_mangle)]
+pub extern "C" fn qail_arena_free(arena: *mut QailArena) {
+    if !arena.is_null() {
+        unsafe {
+            drop(Box::from_raw(arena));
+        }
+    }
+}
+
+/// qail_transpile, allocating the result from `arena` instead of the
+/// heap. The returned string lives until the arena is reset or freed; do
+/// not pass it to qail_free(). Returns NULL on error (check
+/// qail_last_error). Shares the transpile cache with qail_transpile.
+#[unsafe(no_mangle)]
+pub extern "C" fn qail_transpile_a(
+    arena: *mut QailArena,
+    qail: *const c_char,
+) -> *const c_char {
+    clear_error();
+
+    let Some(arena) = (unsafe { arena.as_mut() }) else {
+        set_error("NULL arena".to_string());
+        return std::ptr::null();
+    };
+    if qail.is_null() {
+        set_error("NULL input".to_string());
+        return std::ptr::null();
+    }
+
+    let qail_str = match unsafe { CStr::from_ptr(qail) }.to_str() {
+        Ok(s) => s,
+        Err(e) => {
+            set_error(format!("Invalid UTF-8: {}", e));
+            return std::ptr::null();
+        }
+    };
+
+    if let Some(sql) = cache_get(qail_str) {
+        stats_record(0, 0, sql.len() as u64, false);
+        return arena.alloc(sql.as_bytes(), true) as *const c_char;
+    }
+
+    let parse_start = std::time::Instant::now();
+    match qail_core::parse(qail_str) {
+        Ok(cmd) => {
+            let parse_ns = parse_start.elapsed().as_nanos() as u64;
+            let emit_start = std::time::Instant::now();
+            let sql = cmd.to_sql();
+            let emit_ns = emit_start.elapsed().as_nanos() as u64;
+            stats_record(parse_ns, emit_ns, sql.len() as u64, false);
+            cache_put(qail_str, &sql);
+            arena.alloc(sql.as_bytes(), true) as *const c_char
+        }
+        Err(e) => {
+            stats_record(parse_start.elapsed().as_nanos() as u64, 0, 0, true);
+            set_error(format!("{:?}", e));
+            std::ptr::null()
+        }
+    }
+}
+
+/// qail_parse_json, allocating the JSON string from `arena`.
+/// Same lifetime rules as qail_transpile_a.
+#[unsafe(no_mangle)]
+pub extern "C" fn qail_parse_json_a(
+    arena: *mut QailArena,
+    qail: *const c_char,
+) -> *const c_char {
+    clear_error();
+
+    let Some(arena) = (unsafe { arena.as_mut() }) else {
+        set_error("NULL arena".to_string());
+        return std::ptr::null();
+    };
+    if qail.is_null() {
+        set_error("NULL input".to_string());
+        return std::ptr::null();
+    }
+
+    let qail_str = match unsafe { CStr::from_ptr(qail) }.to_str() {
+        Ok(s) => s,
+        Err(e) => {
+            set_error(format!("Invalid UTF-8: {}", e));
+            return std::ptr::null();
+        }
+    };
+
+    match qail_core::parse(qail_str) {
+        Ok(cmd) => match serde_json::to_string(&cmd) {
+            Ok(json) => arena.alloc(json.as_bytes(), true) as *const c_char,
+            Err(e) => {
+                set_error(format!("JSON serialization error: {}", e));
+                std::ptr::null()
+            }
+        },
+        Err(e) => {
+            set_error(format!("{:?}", e));
+            std::ptr::null()
+        }
+    }
+}
+
+/// qail_encode_get, allocating the wire bytes from `arena`.
+/// Returns the bytes directly (length via out_len) instead of an
+/// out-pointer/return-code pair; NULL + 0 on error. The bytes live until
+/// the arena is reset or freed; do not pass them to qail_free_bytes().
+#[unsafe(no_mangle)]
+pub extern "C" fn qail_encode_get_a(
+    arena: *mut QailArena,
+    table: *const c_char,
+    columns: *const c_char, // comma-separated, or "*" for all
+    limit: i64,             // -1 for no limit
+    out_len: *mut usize,
+) -> *const u8 {
+    clear_error();
+
+    if !out_len.is_null() {
+        unsafe { *out_len = 0 };
+    }
+    let Some(arena) = (unsafe { arena.as_mut() }) else {
+        set_error("NULL arena".to_string());
+        return std::ptr::null();
+    };
+    if table.is_null() || out_len.is_null() {
+        set_error("NULL pointer argument".to_string());
+        return std::ptr::null();
+    }
+
+    let table_str = match unsafe { CStr::from_ptr(table) }.to_str() {
+        Ok(s) => s,
+        Err(e) => {
+            set_error(format!("Invalid UTF-8 in table: {}", e));
+            return std::ptr::null();
+        }
+    };
+
+    let mut cmd = qail_core::ast::Qail::get(table_str);
+    if !columns.is_null() {
+        let cols_str = match unsafe { CStr::from_ptr(columns) }.to_str() {
+            Ok(s) => s,
+            Err(e) => {
+                set_error(format!("Invalid UTF-8 in columns: {}", e));
+                return std::ptr::null();
+            }
+        };
+        if cols_str == "*" {
+            cmd = cmd.select_all();
+        } else {
+            for col in cols_str.split(',') {
+                let col = col.trim();
+                if !col.is_empty() {
+                    cmd = cmd.column(col);
+                }
+            }
+        }
+    } else {
+        cmd = cmd.select_all();
+    }
+    if limit >= 0 {
+        cmd = cmd.limit(limit);
+    }
+
+    let (wire_bytes, _) = AstEncoder::encode_cmd(&cmd);
+    unsafe { *out_len = wire_bytes.len() };
+    arena.alloc(&wire_bytes, false) as *const u8
+}
+
 /// Get QAIL version string.
 /// Caller must free the returned string with qail_free().
 #[unsafe(no_mangle)]
@@ -577,6 +2373,238 @@ mod tests {
         qail_free(result);
     }
 
+    // Serializes tests that reconfigure the process-wide transpile cache.
+    static CACHE_TEST_LOCK: Mutex<()> = Mutex::new(());
+
+    #[test]
+    fn test_init() {
+        let _guard = CACHE_TEST_LOCK.lock().unwrap_or_else(|e| e.into_inner());
+        let mut report = QailInitReport {
+            version: std::ptr::null(),
+            dialects: 0,
+            cache_enabled: 0,
+            wire_encoder: 0,
+            parallel_validate: 0,
+            reserved: 0,
+        };
+        assert_eq!(qail_init(std::ptr::null(), &mut report), 0);
+        assert!(!report.version.is_null());
+        let version = unsafe { CStr::from_ptr(report.version) }.to_str().unwrap();
+        assert_eq!(version, env!("CARGO_PKG_VERSION"));
+        assert_eq!(report.dialects, 0b11);
+        assert_eq!(report.cache_enabled, 0);
+        assert_eq!(report.wire_encoder, 1);
+
+        // Opts enable the cache; leave it disabled again afterwards
+        let opts = QailInitOpts {
+            cache_max_entries: 16,
+            cache_max_bytes: 64 * 1024,
+            warmup_rounds: 2,
+            reserved: 0,
+        };
+        assert_eq!(qail_init(&opts, &mut report), 0);
+        assert_eq!(report.cache_enabled, 1);
+        qail_cache_configure(0, 0);
+    }
+
+    #[test]
+    fn test_validate_batch() {
+        let valid = CString::new("get users fields *").unwrap();
+        let invalid = CString::new("invalid syntax!!!").unwrap();
+        let queries = [valid.as_ptr(), invalid.as_ptr(), valid.as_ptr()];
+
+        let mut bits = [0u8; 1];
+        let rc = qail_validate_batch(queries.as_ptr(), 3, bits.as_mut_ptr());
+        assert_eq!(rc, 0);
+        assert_eq!(bits[0], 0b101);
+
+        // Large batch takes the parallel path
+        let count = VALIDATE_PARALLEL_THRESHOLD + 7;
+        let queries: Vec<*const c_char> = (0..count)
+            .map(|i| {
+                if i % 2 == 0 {
+                    valid.as_ptr()
+                } else {
+                    invalid.as_ptr()
+                }
+            })
+            .collect();
+        let mut bits = vec![0u8; count.div_ceil(8)];
+        let rc = qail_validate_batch(queries.as_ptr(), count, bits.as_mut_ptr());
+        assert_eq!(rc, 0);
+        for i in 0..count {
+            let expected = i % 2 == 0;
+            let got = bits[i / 8] & (1 << (i % 8)) != 0;
+            assert_eq!(got, expected, "query {}", i);
+        }
+    }
+
+    #[test]
+    fn test_parse_bin() {
+        let input = CString::new("get users fields id where email = $1").unwrap();
+        let mut ptr: *mut u8 = std::ptr::null_mut();
+        let mut len: usize = 0;
+        let rc = qail_parse_bin(input.as_ptr(), &mut ptr, &mut len);
+        assert_eq!(rc, 0);
+        assert!(!ptr.is_null());
+
+        let buf = unsafe { std::slice::from_raw_parts(ptr, len) };
+
+        // Header
+        assert_eq!(u32::from_le_bytes(buf[0..4].try_into().unwrap()), QBIN_MAGIC);
+        assert_eq!(u16::from_le_bytes(buf[4..6].try_into().unwrap()), QBIN_VERSION);
+        assert_eq!(buf[6], qail_core::ast::Action::Get as u8);
+
+        // Table name via the string pool
+        let pool_off = u32::from_le_bytes(buf[8..12].try_into().unwrap()) as usize;
+        let table_off = u32::from_le_bytes(buf[16..20].try_into().unwrap()) as usize;
+        let table_len = u32::from_le_bytes(buf[20..24].try_into().unwrap()) as usize;
+        let table = &buf[pool_off + table_off..pool_off + table_off + table_len];
+        assert_eq!(table, b"users");
+
+        // One column, one filter cage with one $1 condition
+        let n_columns = u32::from_le_bytes(buf[24..28].try_into().unwrap());
+        assert_eq!(n_columns, 1);
+        let cages_at = 28 + 8;
+        let n_cages = u32::from_le_bytes(buf[cages_at..cages_at + 4].try_into().unwrap());
+        assert_eq!(n_cages, 1);
+        let cage_at = cages_at + 4;
+        assert_eq!(buf[cage_at], 0); // filter
+        let cond_at = cage_at + 16;
+        assert_eq!(buf[cond_at + 8], qail_core::ast::Operator::Eq as u8);
+        assert_eq!(buf[cond_at + 16], QBIN_VALUE_PARAM);
+        let a = u64::from_le_bytes(buf[cond_at + 24..cond_at + 32].try_into().unwrap());
+        assert_eq!(a, 1);
+
+        qail_free_bytes(ptr, len);
+    }
+
+    #[test]
+    fn test_transpile_cache() {
+        let _guard = CACHE_TEST_LOCK.lock().unwrap_or_else(|e| e.into_inner());
+        assert_eq!(qail_cache_configure(128, 1024 * 1024), 0);
+
+        let input = CString::new("get harbors fields id,name").unwrap();
+        let first = qail_transpile(input.as_ptr());
+        assert!(!first.is_null());
+        let second = qail_transpile(input.as_ptr());
+        assert!(!second.is_null());
+
+        let a = unsafe { CStr::from_ptr(first) }.to_str().unwrap().to_string();
+        let b = unsafe { CStr::from_ptr(second) }.to_str().unwrap();
+        assert_eq!(a, b);
+        qail_free(first);
+        qail_free(second);
+
+        let mut stats = QailCacheStats {
+            hits: 0,
+            misses: 0,
+            entries: 0,
+            bytes: 0,
+        };
+        assert_eq!(qail_cache_stats(&mut stats), 0);
+        assert!(stats.hits >= 1);
+        assert!(stats.entries >= 1);
+        assert!(stats.bytes > 0);
+
+        // Disable and drop everything so other tests see the default state
+        assert_eq!(qail_cache_configure(0, 0), 0);
+        qail_cache_stats(&mut stats);
+        assert_eq!(stats.entries, 0);
+    }
+
+    #[test]
+    fn test_dialect_handle() {
+        let name = CString::new("postgres").unwrap();
+        let dialect = qail_dialect_get(name.as_ptr());
+        assert!(!dialect.is_null());
+
+        let input = CString::new("get users fields *").unwrap();
+        let result = qail_transpile_d(input.as_ptr(), dialect);
+        assert!(!result.is_null());
+        let sql = unsafe { CStr::from_ptr(result) }.to_str().unwrap();
+        assert!(sql.contains("SELECT"));
+        qail_free(result);
+
+        let unknown = CString::new("oracle").unwrap();
+        assert!(qail_dialect_get(unknown.as_ptr()).is_null());
+    }
+
+    #[test]
+    fn test_transpile_into() {
+        let input = CString::new("get users fields *").unwrap();
+        let mut buf = [0i8; 256];
+        let mut len: usize = 0;
+
+        let rc = qail_transpile_into(input.as_ptr(), buf.as_mut_ptr(), buf.len(), &mut len);
+        assert_eq!(rc, 0);
+        let sql = unsafe { CStr::from_ptr(buf.as_ptr()) }.to_str().unwrap();
+        assert_eq!(sql.len(), len);
+        assert!(sql.contains("SELECT"));
+
+        // Undersized buffer: reports required size, writes nothing
+        let mut tiny = [0i8; 4];
+        let mut needed: usize = 0;
+        let rc = qail_transpile_into(input.as_ptr(), tiny.as_mut_ptr(), tiny.len(), &mut needed);
+        assert_eq!(rc, 1);
+        assert_eq!(needed, len);
+    }
+
+    #[test]
+    fn test_prepared_query() {
+        let input = CString::new("get users fields id where email = $1").unwrap();
+        let query = qail_prepare(input.as_ptr());
+        assert!(!query.is_null(), "prepare returned null");
+
+        let email = CString::new("a@b.com").unwrap();
+        assert_eq!(qail_bind_text(query, 1, email.as_ptr()), 0);
+
+        let result = qail_query_transpile(query);
+        assert!(!result.is_null());
+        let sql = unsafe { CStr::from_ptr(result) }.to_str().unwrap();
+        assert!(sql.contains("'a@b.com'"));
+        qail_free(result);
+
+        // Rebind and transpile again without re-parsing
+        let email2 = CString::new("c@d.com").unwrap();
+        assert_eq!(qail_bind_text(query, 1, email2.as_ptr()), 0);
+        let result = qail_query_transpile(query);
+        let sql = unsafe { CStr::from_ptr(result) }.to_str().unwrap();
+        assert!(sql.contains("'c@d.com'"));
+        qail_free(result);
+
+        qail_query_free(query);
+    }
+
+    #[test]
+    fn test_transpile_batch() {
+        let q1 = CString::new("get users fields *").unwrap();
+        let q2 = CString::new("invalid syntax!!!").unwrap();
+        let queries = [q1.as_ptr(), q2.as_ptr()];
+
+        let mut ptr: *mut u8 = std::ptr::null_mut();
+        let mut len: usize = 0;
+        let rc = qail_transpile_batch(queries.as_ptr(), 2, &mut ptr, &mut len);
+        assert_eq!(rc, 0);
+        assert!(!ptr.is_null());
+
+        let buf = unsafe { std::slice::from_raw_parts(ptr, len) };
+
+        // First entry: valid SQL
+        let sql_len = u32::from_le_bytes(buf[..4].try_into().unwrap()) as usize;
+        assert!(sql_len > 0);
+        let sql = std::str::from_utf8(&buf[4..4 + sql_len]).unwrap();
+        assert!(sql.contains("SELECT"));
+
+        // Second entry: failed query packed with length 0
+        let off = 4 + sql_len;
+        let err_len = u32::from_le_bytes(buf[off..off + 4].try_into().unwrap());
+        assert_eq!(err_len, 0);
+        assert_eq!(len, off + 4);
+
+        qail_free_bytes(ptr, len);
+    }
+
     #[test]
     fn test_validate() {
         let valid = CString::new("get users fields *").unwrap();
@@ -591,4 +2619,190 @@ mod tests {
         let result = qail_transpile(std::ptr::null());
         assert!(result.is_null());
     }
+
+    #[test]
+    fn test_stream() {
+        let file = "# migration header\n\
+                    get users fields id, email limit 10;\n\
+                    \n\
+                    get orders\nfields id\nwhere user_id = $1\n\
+                    \n\
+                    not a valid statement!!!\n\
+                    \n\
+                    del sessions where id = 'semi;colon'\n";
+        let stream = qail_stream_open(file.as_ptr() as *const c_char, file.len());
+        assert!(!stream.is_null());
+
+        let mut sql: *const c_char = std::ptr::null();
+        let mut len: usize = 0;
+
+        assert_eq!(qail_stream_next(stream, &mut sql, &mut len), 1);
+        let first = unsafe { CStr::from_ptr(sql) }.to_str().unwrap();
+        assert!(first.contains("SELECT") && first.contains("LIMIT 10"));
+        assert_eq!(first.len(), len);
+
+        assert_eq!(qail_stream_next(stream, &mut sql, &mut len), 1);
+        let second = unsafe { CStr::from_ptr(sql) }.to_str().unwrap();
+        assert!(second.contains("orders") && second.contains("$1"));
+
+        // Bad statement reports an error but the stream stays usable
+        assert_eq!(qail_stream_next(stream, &mut sql, &mut len), -1);
+
+        assert_eq!(qail_stream_next(stream, &mut sql, &mut len), 1);
+        let fourth = unsafe { CStr::from_ptr(sql) }.to_str().unwrap();
+        assert!(fourth.contains("DELETE") && fourth.contains("semi;colon"));
+
+        // End of input
+        assert_eq!(qail_stream_next(stream, &mut sql, &mut len), 0);
+
+        qail_stream_free(stream);
+    }
+
+    #[test]
+    fn test_validate_prepass() {
+        // Valid queries must pass the screen
+        for q in [
+            "get users fields *",
+            "GET users fields id where email = $1",
+            "  with x as (get users fields id) get x fields *",
+            "begin",
+            "delete orders where id = 1",
+            "get users fields id where name = 'tab\tinside'",
+        ] {
+            assert!(validate_prepass(q), "prepass rejected valid query: {:?}", q);
+        }
+
+        // Structurally hopeless input is rejected without a parse
+        assert!(!validate_prepass(""));
+        assert!(!validate_prepass("   "));
+        assert!(!validate_prepass("select * from users"));
+        assert!(!validate_prepass("get\x01users fields id"));
+
+        // Soundness fuzz: anything the pre-pass rejects, the parser must
+        // also reject. Deterministic LCG so failures reproduce.
+        let pool: &[u8] = b"getselinsrtdelcreatewith users fields*,'=$1\x00\x01\x02\x1f\t\n ()";
+        let mut state: u64 = 0x9E3779B97F4A7C15;
+        for _ in 0..5000 {
+            let mut s = String::new();
+            let len = (state % 48) as usize + 1;
+            for _ in 0..len {
+                state = state.wrapping_mul(6364136223846793005).wrapping_add(1);
+                let b = pool[(state >> 33) as usize % pool.len()];
+                if b != 0 {
+                    s.push(b as char);
+                }
+            }
+            if !validate_prepass(&s) {
+                assert!(
+                    qail_core::parse(&s).is_err(),
+                    "prepass rejected but parser accepts: {:?}",
+                    s
+                );
+            }
+        }
+    }
+
+    #[test]
+    #[cfg(feature = "stats")]
+    fn test_stats() {
+        let mut before = QailStats {
+            calls: 0,
+            parse_ns: 0,
+            emit_ns: 0,
+            bytes_alloc: 0,
+            cache_hits: 0,
+            cache_misses: 0,
+            errors: 0,
+            enabled: 0,
+            reserved: [0; 7],
+        };
+        assert_eq!(qail_stats(&mut before), 0);
+        assert_eq!(before.enabled, 1);
+
+        let query = CString::new("get users fields id where email = $1").unwrap();
+        for _ in 0..3 {
+            let sql = qail_transpile(query.as_ptr());
+            assert!(!sql.is_null());
+            qail_free(sql);
+        }
+        let invalid = CString::new("invalid syntax!!!").unwrap();
+        assert!(qail_transpile(invalid.as_ptr()).is_null());
+
+        let mut after = before;
+        assert_eq!(qail_stats(&mut after), 0);
+
+        // Counters are process-global, so other tests may add on top;
+        // only the minimum deltas from this thread are guaranteed.
+        assert!(after.calls >= before.calls + 4);
+        assert!(after.parse_ns > before.parse_ns);
+        assert!(after.emit_ns > before.emit_ns);
+        assert!(after.bytes_alloc > before.bytes_alloc);
+        assert!(after.errors >= before.errors + 1);
+    }
+
+    #[test]
+    fn test_arena() {
+        let arena = qail_arena_new(0);
+        assert!(!arena.is_null());
+
+        // Arena results match the heap-allocated versions byte for byte.
+        let query = CString::new("get users fields id, name limit 5").unwrap();
+        let sql_a = qail_transpile_a(arena, query.as_ptr());
+        assert!(!sql_a.is_null());
+        let heap_sql = qail_transpile(query.as_ptr());
+        assert_eq!(unsafe { CStr::from_ptr(sql_a) }, unsafe {
+            CStr::from_ptr(heap_sql)
+        });
+        qail_free(heap_sql);
+
+        let json_a = qail_parse_json_a(arena, query.as_ptr());
+        assert!(!json_a.is_null());
+        let json = unsafe { CStr::from_ptr(json_a) }.to_str().unwrap();
+        assert!(json.contains("users"));
+
+        let table = CString::new("users").unwrap();
+        let cols = CString::new("id, name").unwrap();
+        let mut len_a: usize = 0;
+        let bytes_a = qail_encode_get_a(arena, table.as_ptr(), cols.as_ptr(), 5, &mut len_a);
+        assert!(!bytes_a.is_null());
+        let mut heap_ptr: *mut u8 = std::ptr::null_mut();
+        let mut heap_len: usize = 0;
+        assert_eq!(
+            qail_encode_get(table.as_ptr(), cols.as_ptr(), 5, &mut heap_ptr, &mut heap_len),
+            0
+        );
+        assert_eq!(len_a, heap_len);
+        let arena_bytes = unsafe { std::slice::from_raw_parts(bytes_a, len_a) };
+        let heap_bytes = unsafe { std::slice::from_raw_parts(heap_ptr, heap_len) };
+        assert_eq!(arena_bytes, heap_bytes);
+        qail_free_bytes(heap_ptr, heap_len);
+
+        // Earlier results stay valid as the arena grows across chunks.
+        let big = CString::new(format!(
+            "get users fields {}",
+            (0..500).map(|i| format!("col{}", i)).collect::<Vec<_>>().join(", ")
+        ))
+        .unwrap();
+        for _ in 0..300 {
+            assert!(!qail_transpile_a(arena, big.as_ptr()).is_null());
+        }
+        assert_eq!(
+            unsafe { CStr::from_ptr(sql_a) }.to_str().unwrap(),
+            "SELECT id, name FROM users LIMIT 5"
+        );
+
+        // Errors return NULL without touching the arena.
+        let invalid = CString::new("invalid syntax!!!").unwrap();
+        assert!(qail_transpile_a(arena, invalid.as_ptr()).is_null());
+        assert!(qail_parse_json_a(arena, invalid.as_ptr()).is_null());
+
+        // Reset reuses the initial chunk: the first allocation afterwards
+        // lands at the same address.
+        qail_arena_reset(arena);
+        let again = qail_transpile_a(arena, query.as_ptr());
+        assert_eq!(again, sql_a);
+
+        qail_arena_free(arena);
+        qail_arena_free(std::ptr::null_mut()); // NULL is a no-op
+    }
 }
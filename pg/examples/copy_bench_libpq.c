@@ -0,0 +1,348 @@
+/*
+ * COPY BULK-INGEST BENCHMARK - C libpq (PostgreSQL native driver)
+ *
+ * Streams rows through COPY ... FROM STDIN BINARY with PQputCopyData to
+ * measure the native ingest ceiling the Rust COPY path is compared
+ * against (see the "Bulk Operations / COPY Protocol" section in
+ * PERFORMANCE.md). Row count and chunk size are tunable so the same
+ * binary can sweep small-chunk vs large-chunk behaviour on one box.
+ *
+ * Rows are (bigint, text) pairs written into an UNLOGGED table that is
+ * created (and dropped) by the benchmark itself, so no fixture data is
+ * required — only a reachable server.
+ *
+ * Build: make copy_bench_libpq   (see pg/examples/Makefile)
+ * Run:   ./copy_bench_libpq -d "host=127.0.0.1 user=postgres dbname=postgres" \
+ *                           -n 10000000 -c 256 -o csv
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <libpq-fe.h>
+
+#define DEFAULT_DSN   "host=127.0.0.1 port=5432 user=postgres dbname=postgres"
+#define DEFAULT_TABLE "copy_bench_qail"
+
+typedef enum { OUT_TEXT, OUT_CSV, OUT_JSON } output_format;
+
+typedef struct copy_config {
+    const char*   dsn;
+    const char*   table;
+    long          rows;      /* total rows to stream */
+    long          chunk_kb;  /* PQputCopyData chunk size in KB */
+    long          per_copy;  /* rows per COPY statement, 0 = all in one */
+    int           keep;      /* keep the table (and its rows) afterwards */
+    output_format format;
+} copy_config;
+
+static double get_time_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static void usage(const char* argv0) {
+    fprintf(stderr, "Usage: %s [options]\n", argv0);
+    fprintf(stderr, "  -d DSN    connection string (default: \"%s\")\n",
+            DEFAULT_DSN);
+    fprintf(stderr, "  -t NAME   target table name (default %s);\n",
+            DEFAULT_TABLE);
+    fprintf(stderr, "            created UNLOGGED as (id bigint, name text)\n");
+    fprintf(stderr, "  -n COUNT  total rows to stream (default 10000000)\n");
+    fprintf(stderr, "  -c KB     PQputCopyData chunk size in KB (default 256)\n");
+    fprintf(stderr, "  -b COUNT  rows per COPY statement (default: all in one)\n");
+    fprintf(stderr, "  -k        keep the table after the run instead of dropping it\n");
+    fprintf(stderr, "  -o FMT    output format: text, csv or json (default text)\n");
+}
+
+static int parse_args(int argc, char** argv, copy_config* cfg) {
+    cfg->dsn = getenv("PGDSN") ? getenv("PGDSN") : DEFAULT_DSN;
+    cfg->table = DEFAULT_TABLE;
+    cfg->rows = 10000000;
+    cfg->chunk_kb = 256;
+    cfg->per_copy = 0;
+    cfg->keep = 0;
+    cfg->format = OUT_TEXT;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "d:t:n:c:b:ko:h")) != -1) {
+        switch (opt) {
+            case 'd': cfg->dsn = optarg; break;
+            case 't': cfg->table = optarg; break;
+            case 'n': cfg->rows = atol(optarg); break;
+            case 'c': cfg->chunk_kb = atol(optarg); break;
+            case 'b': cfg->per_copy = atol(optarg); break;
+            case 'k': cfg->keep = 1; break;
+            case 'o':
+                if (strcmp(optarg, "text") == 0) cfg->format = OUT_TEXT;
+                else if (strcmp(optarg, "csv") == 0) cfg->format = OUT_CSV;
+                else if (strcmp(optarg, "json") == 0) cfg->format = OUT_JSON;
+                else {
+                    fprintf(stderr, "Unknown output format: %s\n", optarg);
+                    return -1;
+                }
+                break;
+            case 'h':
+            default:
+                usage(argv[0]);
+                return -1;
+        }
+    }
+    if (cfg->rows <= 0 || cfg->chunk_kb <= 0 || cfg->per_copy < 0) {
+        fprintf(stderr, "Row count and chunk size must be positive\n");
+        return -1;
+    }
+    return 0;
+}
+
+/* Growable byte buffer with big-endian writers for the COPY binary
+ * wire format (PGCOPY header, per-row field counts, length-prefixed
+ * field payloads). */
+typedef struct copy_buf {
+    unsigned char* data;
+    size_t         len;
+    size_t         cap;
+} copy_buf;
+
+static void buf_reserve(copy_buf* b, size_t extra) {
+    if (b->len + extra <= b->cap) return;
+    while (b->cap < b->len + extra) b->cap = b->cap ? b->cap * 2 : 4096;
+    b->data = realloc(b->data, b->cap);
+    if (b->data == NULL) {
+        fprintf(stderr, "Out of memory growing COPY buffer\n");
+        exit(1);
+    }
+}
+
+static void buf_u16(copy_buf* b, uint16_t v) {
+    buf_reserve(b, 2);
+    b->data[b->len++] = (unsigned char)(v >> 8);
+    b->data[b->len++] = (unsigned char)v;
+}
+
+static void buf_u32(copy_buf* b, uint32_t v) {
+    buf_reserve(b, 4);
+    b->data[b->len++] = (unsigned char)(v >> 24);
+    b->data[b->len++] = (unsigned char)(v >> 16);
+    b->data[b->len++] = (unsigned char)(v >> 8);
+    b->data[b->len++] = (unsigned char)v;
+}
+
+static void buf_u64(copy_buf* b, uint64_t v) {
+    buf_u32(b, (uint32_t)(v >> 32));
+    buf_u32(b, (uint32_t)v);
+}
+
+static void buf_bytes(copy_buf* b, const void* src, size_t n) {
+    buf_reserve(b, n);
+    memcpy(b->data + b->len, src, n);
+    b->len += n;
+}
+
+/* "PGCOPY\n\377\r\n\0" signature + flags + header extension length */
+static void buf_copy_header(copy_buf* b) {
+    static const unsigned char sig[11] = "PGCOPY\n\377\r\n";
+    buf_bytes(b, sig, sizeof(sig));
+    buf_u32(b, 0); /* flags */
+    buf_u32(b, 0); /* header extension length */
+}
+
+/* One (bigint, text) row: field count, then int32 length + payload per
+ * field. The name cycles through a fixed pool so payload sizes vary the
+ * way a real ingest would without paying snprintf per row. */
+static void buf_copy_row(copy_buf* b, long id) {
+    static const char* names[] = {
+        "Rotterdam", "Singapore", "Shanghai", "Antwerp",
+        "Hamburg",   "Los Angeles", "Busan",  "Ningbo-Zhoushan",
+    };
+    const char* name = names[id % 8];
+    size_t name_len = strlen(name);
+
+    buf_u16(b, 2);                /* field count */
+    buf_u32(b, 8);                /* int8 payload length */
+    buf_u64(b, (uint64_t)id);
+    buf_u32(b, (uint32_t)name_len);
+    buf_bytes(b, name, name_len);
+}
+
+static int exec_ok(PGconn* conn, const char* sql) {
+    PGresult* res = PQexec(conn, sql);
+    int ok = PQresultStatus(res) == PGRES_COMMAND_OK;
+    if (!ok) fprintf(stderr, "%s failed: %s\n", sql, PQerrorMessage(conn));
+    PQclear(res);
+    return ok;
+}
+
+/* Stream [first, first+count) through one COPY statement, flushing the
+ * buffer to PQputCopyData whenever it crosses the chunk size. Returns 0
+ * on success and adds the bytes sent to *bytes_out. */
+static int run_copy(PGconn* conn, const copy_config* cfg, long first,
+                    long count, copy_buf* buf, long* bytes_out) {
+    char sql[256];
+    snprintf(sql, sizeof(sql), "COPY %s (id, name) FROM STDIN BINARY",
+             cfg->table);
+
+    PGresult* res = PQexec(conn, sql);
+    if (PQresultStatus(res) != PGRES_COPY_IN) {
+        fprintf(stderr, "COPY failed to start: %s\n", PQerrorMessage(conn));
+        PQclear(res);
+        return -1;
+    }
+    PQclear(res);
+
+    size_t chunk = (size_t)cfg->chunk_kb * 1024;
+    buf->len = 0;
+    buf_copy_header(buf);
+
+    for (long i = 0; i < count; i++) {
+        buf_copy_row(buf, first + i);
+        if (buf->len >= chunk) {
+            if (PQputCopyData(conn, (const char*)buf->data, (int)buf->len) != 1) {
+                fprintf(stderr, "PQputCopyData failed: %s\n",
+                        PQerrorMessage(conn));
+                return -1;
+            }
+            *bytes_out += (long)buf->len;
+            buf->len = 0;
+        }
+    }
+
+    buf_u16(buf, 0xFFFF); /* file trailer: -1 field count */
+    if (PQputCopyData(conn, (const char*)buf->data, (int)buf->len) != 1 ||
+        PQputCopyEnd(conn, NULL) != 1) {
+        fprintf(stderr, "COPY finish failed: %s\n", PQerrorMessage(conn));
+        return -1;
+    }
+    *bytes_out += (long)buf->len;
+    buf->len = 0;
+
+    res = PQgetResult(conn);
+    int ok = PQresultStatus(res) == PGRES_COMMAND_OK;
+    if (!ok) fprintf(stderr, "COPY failed: %s\n", PQerrorMessage(conn));
+    PQclear(res);
+    /* Drain the NULL result that marks end of command */
+    res = PQgetResult(conn);
+    if (res) PQclear(res);
+    return ok ? 0 : -1;
+}
+
+static void print_result(const copy_config* cfg, long rows, long bytes,
+                         long copies, double wall_s) {
+    double rows_s = rows / wall_s;
+    double mb = bytes / (1024.0 * 1024.0);
+    double mb_s = mb / wall_s;
+
+    switch (cfg->format) {
+        case OUT_CSV:
+            printf("rows,bytes,copies,chunk_kb,elapsed_s,rows_per_sec,mb_per_sec\n");
+            printf("%ld,%ld,%ld,%ld,%.3f,%.0f,%.1f\n", rows, bytes, copies,
+                   cfg->chunk_kb, wall_s, rows_s, mb_s);
+            break;
+        case OUT_JSON:
+            printf("{\"rows\":%ld,\"bytes\":%ld,\"copies\":%ld,"
+                   "\"chunk_kb\":%ld,\"elapsed_s\":%.3f,"
+                   "\"rows_per_sec\":%.0f,\"mb_per_sec\":%.1f}\n",
+                   rows, bytes, copies, cfg->chunk_kb, wall_s, rows_s, mb_s);
+            break;
+        case OUT_TEXT:
+        default:
+            printf("\n📈 FINAL RESULTS:\n");
+            printf("┌──────────────────────────────────────────┐\n");
+            printf("│ COPY BINARY INGEST                       │\n");
+            printf("├──────────────────────────────────────────┤\n");
+            printf("│ Rows:              %20ld │\n", rows);
+            printf("│ Bytes Sent:        %18.1fMB │\n", mb);
+            printf("│ COPY Statements:   %20ld │\n", copies);
+            printf("│ Chunk Size:        %18ldKB │\n", cfg->chunk_kb);
+            printf("│ Total Time:        %20.1fs │\n", wall_s);
+            printf("│ Rows/Second:       %20.0f │\n", rows_s);
+            printf("│ Throughput:        %16.1fMB/s │\n", mb_s);
+            printf("└──────────────────────────────────────────┘\n");
+            break;
+    }
+}
+
+int main(int argc, char** argv) {
+    copy_config cfg;
+    if (parse_args(argc, argv, &cfg) != 0) {
+        return 1;
+    }
+
+    int verbose = (cfg.format == OUT_TEXT);
+    if (verbose) {
+        printf("🔧 COPY BULK-INGEST BENCHMARK\n");
+        printf("=============================\n");
+        printf("Table:            %s\n", cfg.table);
+        printf("Rows:             %15ld\n", cfg.rows);
+        printf("Chunk size:       %13ldKB\n", cfg.chunk_kb);
+        if (cfg.per_copy > 0) {
+            printf("Rows per COPY:    %15ld\n", cfg.per_copy);
+        }
+        printf("\n");
+    }
+
+    PGconn* conn = PQconnectdb(cfg.dsn);
+    if (PQstatus(conn) != CONNECTION_OK) {
+        fprintf(stderr, "Connection failed: %s\n", PQerrorMessage(conn));
+        PQfinish(conn);
+        return 1;
+    }
+
+    char sql[256];
+    snprintf(sql, sizeof(sql),
+             "CREATE UNLOGGED TABLE IF NOT EXISTS %s (id bigint, name text)",
+             cfg.table);
+    if (!exec_ok(conn, sql)) {
+        PQfinish(conn);
+        return 1;
+    }
+
+    long per_copy = cfg.per_copy > 0 ? cfg.per_copy : cfg.rows;
+    long sent = 0;
+    long bytes = 0;
+    long copies = 0;
+    int failed = 0;
+    copy_buf buf = {0};
+
+    if (verbose) {
+        printf("📊 Streaming %ld rows in %ldKB chunks...\n",
+               cfg.rows, cfg.chunk_kb);
+    }
+
+    double wall_start = get_time_ms();
+    while (sent < cfg.rows) {
+        long count = cfg.rows - sent < per_copy ? cfg.rows - sent : per_copy;
+        if (run_copy(conn, &cfg, sent, count, &buf, &bytes) != 0) {
+            failed = 1;
+            break;
+        }
+        sent += count;
+        copies++;
+
+        if (verbose && cfg.per_copy > 0 && copies % 10 == 0) {
+            double elapsed = (get_time_ms() - wall_start) / 1000.0;
+            fprintf(stderr, "   COPY %ld: %.0f rows/s\n", copies,
+                    sent / elapsed);
+        }
+    }
+    double wall_s = (get_time_ms() - wall_start) / 1000.0;
+
+    if (!cfg.keep) {
+        snprintf(sql, sizeof(sql), "DROP TABLE %s", cfg.table);
+        exec_ok(conn, sql);
+    }
+    free(buf.data);
+    PQfinish(conn);
+
+    if (failed) {
+        fprintf(stderr, "COPY benchmark failed after %ld rows\n", sent);
+        return 1;
+    }
+
+    print_result(&cfg, sent, bytes, copies, wall_s);
+    return 0;
+}
@@ -0,0 +1,969 @@
+/*
+ * LIBPQ BENCHMARK HARNESS - C libpq (PostgreSQL native driver)
+ *
+ * Replaces the hardcoded million_libpq.c / fifty_million_libpq.c examples
+ * with a single configurable harness: DSN, query, batch size, query count
+ * and warmup all come from the command line, and results can be emitted
+ * as text, CSV or JSON for regression tracking across QAIL releases.
+ *
+ * Uses PostgreSQL's official C driver with pipelining (PG 14+) as the
+ * baseline the QAIL driver is measured against.
+ *
+ * Build: make libpq_bench   (see pg/examples/Makefile)
+ * Run:   ./libpq_bench -d "host=127.0.0.1 user=postgres dbname=postgres" \
+ *                      -q "SELECT id, name FROM harbors LIMIT $1" \
+ *                      -n 1000000 -b 1000 -w 10000 -o csv
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+#include <libpq-fe.h>
+
+#define DEFAULT_DSN   "host=127.0.0.1 port=5432 user=postgres dbname=postgres"
+#define DEFAULT_QUERY "SELECT id, name FROM harbors LIMIT $1"
+
+/* Wide-row decode query (-W): mixed int/float/text/timestamp columns
+ * generated server-side, $1 rows per query. Measures result-set decode
+ * throughput rather than round-trip overhead. */
+#define WIDE_QUERY \
+    "SELECT g.id, g.id * 1664525 + 1013904223 AS mixed, " \
+    "g.id::float8 * 1.0001 AS ratio, 'row_' || g.id AS name, " \
+    "md5(g.id::text) AS hash, " \
+    "timestamp '2026-01-01' + g.id * interval '1 second' AS ts " \
+    "FROM generate_series(1, $1::int) AS g(id)"
+
+typedef enum { OUT_TEXT, OUT_CSV, OUT_JSON } output_format;
+
+typedef struct bench_config {
+    const char*   dsn;
+    char*         query;        /* owned when loaded from a file */
+    long          total_queries;
+    int           batch_size;
+    long          warmup;
+    int           connections;
+    long          sample;        /* per-query sampling interval, 0 = off */
+    int           mem_interval;  /* memory sampling interval ms, 0 = off */
+    int           result_format; /* 0 = text results, 1 = binary results */
+    int           compare_formats; /* run both and report side by side */
+    long          wide_rows;     /* rows per query in wide mode, 0 = off */
+    output_format format;
+} bench_config;
+
+typedef struct bench_result {
+    long   queries;
+    long   successful;
+    long   rows;   /* rows decoded across all results */
+    long   bytes;  /* field payload bytes decoded */
+    double elapsed_s;
+} bench_result;
+
+/*
+ * HDR-style log-linear latency histogram, microsecond resolution.
+ *
+ * Values are bucketed by power of two with HIST_SUB (32) linear
+ * sub-buckets each, so relative error stays under ~3% from 1us up past
+ * 100s while the whole table is a fixed 12KB array — no allocation on
+ * the hot path. Samples land in a preallocated ring first and are
+ * folded into the histogram when the ring fills, keeping the per-batch
+ * cost to one array store.
+ */
+#define HIST_SUB_BITS 5
+#define HIST_SUB      (1 << HIST_SUB_BITS)
+#define HIST_BUCKETS  (48 * HIST_SUB)
+#define LAT_RING      4096
+
+typedef struct latency_hist {
+    long   counts[HIST_BUCKETS];
+    long   total;
+    double max_us;
+    double ring[LAT_RING];
+    int    ring_n;
+} latency_hist;
+
+static int hist_index(double us) {
+    long v = (long)us;
+    if (v < HIST_SUB) return v < 1 ? 1 : (int)v;
+    int msb = 63 - __builtin_clzl((unsigned long)v);
+    int sub = (int)((v >> (msb - HIST_SUB_BITS)) & (HIST_SUB - 1));
+    int idx = (msb - HIST_SUB_BITS + 1) * HIST_SUB + sub;
+    return idx < HIST_BUCKETS ? idx : HIST_BUCKETS - 1;
+}
+
+static double hist_bucket_value(int idx) {
+    if (idx < HIST_SUB) return (double)idx;
+    int msb = idx / HIST_SUB + HIST_SUB_BITS - 1;
+    int sub = idx % HIST_SUB;
+    return (double)(((long)1 << msb) + ((long)sub << (msb - HIST_SUB_BITS)));
+}
+
+static void hist_flush(latency_hist* h) {
+    for (int i = 0; i < h->ring_n; i++) {
+        double us = h->ring[i];
+        h->counts[hist_index(us)]++;
+        h->total++;
+        if (us > h->max_us) h->max_us = us;
+    }
+    h->ring_n = 0;
+}
+
+static void hist_record(latency_hist* h, double us) {
+    if (h->ring_n == LAT_RING) hist_flush(h);
+    h->ring[h->ring_n++] = us;
+}
+
+static void hist_merge(latency_hist* into, const latency_hist* from) {
+    for (int i = 0; i < HIST_BUCKETS; i++) into->counts[i] += from->counts[i];
+    into->total += from->total;
+    if (from->max_us > into->max_us) into->max_us = from->max_us;
+}
+
+static double hist_percentile(const latency_hist* h, double p) {
+    if (h->total == 0) return 0.0;
+    long target = (long)(p / 100.0 * h->total + 0.5);
+    if (target < 1) target = 1;
+    long seen = 0;
+    for (int i = 0; i < HIST_BUCKETS; i++) {
+        seen += h->counts[i];
+        if (seen >= target) return hist_bucket_value(i);
+    }
+    return h->max_us;
+}
+
+/*
+ * Memory telemetry: a background thread samples VmRSS/VmHWM from
+ * /proc/self/status and glibc's in-use heap bytes at a fixed interval,
+ * so soak runs can catch leak-per-batch regressions instead of just
+ * claiming memory stability. Steady state is everything after the first
+ * quarter of samples (connection setup and cache warm distort the
+ * start); a run is flagged as monotonic growth when RSS rises across
+ * >= 90% of steady-state intervals and ends more than 10% above where
+ * steady state began.
+ */
+#define MEM_MAX_SAMPLES 8192
+
+typedef struct mem_sample {
+    long rss_kb;
+    long hwm_kb;
+    long heap_kb;  /* glibc in-use allocation, -1 if unavailable */
+} mem_sample;
+
+typedef struct mem_telemetry {
+    mem_sample samples[MEM_MAX_SAMPLES];
+    int        count;
+    int        interval_ms;
+    volatile int running;
+    pthread_t  thread;
+} mem_telemetry;
+
+static void mem_sample_now(mem_sample* s) {
+    s->rss_kb = -1;
+    s->hwm_kb = -1;
+    s->heap_kb = -1;
+
+    FILE* f = fopen("/proc/self/status", "r");
+    if (f != NULL) {
+        char line[128];
+        while (fgets(line, sizeof(line), f)) {
+            if (strncmp(line, "VmRSS:", 6) == 0) s->rss_kb = atol(line + 6);
+            else if (strncmp(line, "VmHWM:", 6) == 0) s->hwm_kb = atol(line + 6);
+        }
+        fclose(f);
+    }
+#ifdef __GLIBC__
+    struct mallinfo2 mi = mallinfo2();
+    s->heap_kb = (long)(mi.uordblks / 1024);
+#endif
+}
+
+static void* mem_telemetry_main(void* arg) {
+    mem_telemetry* mt = (mem_telemetry*)arg;
+    while (mt->running) {
+        if (mt->count < MEM_MAX_SAMPLES) {
+            mem_sample_now(&mt->samples[mt->count]);
+            mt->count++;
+        }
+        usleep(mt->interval_ms * 1000);
+    }
+    /* Final sample so the end state is always captured */
+    if (mt->count < MEM_MAX_SAMPLES) {
+        mem_sample_now(&mt->samples[mt->count]);
+        mt->count++;
+    }
+    return NULL;
+}
+
+static void mem_telemetry_start(mem_telemetry* mt, int interval_ms) {
+    mt->count = 0;
+    mt->interval_ms = interval_ms;
+    mt->running = 1;
+    pthread_create(&mt->thread, NULL, mem_telemetry_main, mt);
+}
+
+static void mem_telemetry_stop(mem_telemetry* mt) {
+    mt->running = 0;
+    pthread_join(mt->thread, NULL);
+}
+
+typedef struct mem_summary {
+    long peak_kb;        /* VmHWM at end of run */
+    long steady_kb;      /* mean steady-state RSS */
+    long end_kb;         /* final RSS */
+    long end_heap_kb;    /* final glibc in-use heap, -1 if unavailable */
+    int  monotonic;      /* 1 if RSS grew across the steady-state window */
+} mem_summary;
+
+static void mem_summarize(const mem_telemetry* mt, mem_summary* out) {
+    memset(out, 0, sizeof(*out));
+    out->end_heap_kb = -1;
+    if (mt->count == 0) return;
+
+    const mem_sample* last = &mt->samples[mt->count - 1];
+    out->peak_kb = last->hwm_kb;
+    out->end_kb = last->rss_kb;
+    out->end_heap_kb = last->heap_kb;
+
+    int steady_from = mt->count / 4;
+    long sum = 0;
+    int rising = 0;
+    int intervals = 0;
+    for (int i = steady_from; i < mt->count; i++) {
+        sum += mt->samples[i].rss_kb;
+        if (i > steady_from) {
+            intervals++;
+            if (mt->samples[i].rss_kb > mt->samples[i - 1].rss_kb) rising++;
+        }
+    }
+    out->steady_kb = sum / (mt->count - steady_from);
+
+    long steady_start = mt->samples[steady_from].rss_kb;
+    out->monotonic = intervals >= 4 && rising * 10 >= intervals * 9 &&
+                     out->end_kb > steady_start + steady_start / 10;
+}
+
+double get_time_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+/* Sink for decoded field values so the decode work below cannot be
+ * optimized away. */
+static volatile unsigned long decode_sink;
+
+/* Touch and decode every field of a result: binary int4/int8 are
+ * byte-swapped, text digits go through strtol, anything else is
+ * checksummed byte-wise. This keeps the text-vs-binary comparison
+ * honest — both sides pay their real decode cost. Returns the row
+ * count and adds the field payload bytes to *bytes_out. */
+static long decode_result(PGresult* res, int binary, long* bytes_out) {
+    unsigned long sink = 0;
+    long bytes = 0;
+    int rows = PQntuples(res);
+    int cols = PQnfields(res);
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < cols; c++) {
+            if (PQgetisnull(res, r, c)) continue;
+            const char* v = PQgetvalue(res, r, c);
+            int len = PQgetlength(res, r, c);
+            bytes += len;
+            if (binary && len == 4) {
+                sink += (unsigned long)((uint32_t)(unsigned char)v[0] << 24 |
+                                        (uint32_t)(unsigned char)v[1] << 16 |
+                                        (uint32_t)(unsigned char)v[2] << 8 |
+                                        (uint32_t)(unsigned char)v[3]);
+            } else if (binary && len == 8) {
+                unsigned long x = 0;
+                for (int i = 0; i < 8; i++) x = (x << 8) | (unsigned char)v[i];
+                sink += x;
+            } else if (!binary && len > 0 &&
+                       (v[0] == '-' || (v[0] >= '0' && v[0] <= '9'))) {
+                sink += (unsigned long)strtol(v, NULL, 10);
+            } else {
+                for (int i = 0; i < len; i++) sink += (unsigned char)v[i];
+            }
+        }
+    }
+    decode_sink += sink;
+    if (bytes_out != NULL) *bytes_out += bytes;
+    return rows;
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  -d DSN    connection string (default: \"%s\")\n"
+            "  -q SQL    query text; $1 is bound to a cycling 1..10 value\n"
+            "            (default: \"%s\")\n"
+            "  -f FILE   read the query from a file instead of -q\n"
+            "  -n COUNT  total queries (default 1000000)\n"
+            "  -b SIZE   pipeline batch size (default 1000)\n"
+            "  -w COUNT  warmup queries, excluded from results (default 10000)\n"
+            "  -j N      parallel connections, one thread each (default 1)\n"
+            "  -s N      sample every Nth query for per-query latency (default off)\n"
+            "  -m MS     sample VmRSS/VmHWM and heap every MS ms (default off)\n"
+            "  -F FMT    result format: text, binary, or both for a\n"
+            "            side-by-side comparison (default text)\n"
+            "  -W ROWS   wide-result decode mode: select ROWS wide rows\n"
+            "            (int/float/text/timestamp columns) per query and\n"
+            "            report rows/sec and MB/sec alongside q/s\n"
+            "  -o FMT    output format: text, csv or json (default text)\n",
+            prog, DEFAULT_DSN, DEFAULT_QUERY);
+}
+
+static char* load_query_file(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (f == NULL) {
+        fprintf(stderr, "Cannot open query file: %s\n", path);
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (size <= 0) {
+        fclose(f);
+        fprintf(stderr, "Empty query file: %s\n", path);
+        return NULL;
+    }
+    char* buf = malloc(size + 1);
+    if (fread(buf, 1, size, f) != (size_t)size) {
+        fclose(f);
+        free(buf);
+        fprintf(stderr, "Cannot read query file: %s\n", path);
+        return NULL;
+    }
+    fclose(f);
+    buf[size] = '\0';
+    /* Trim trailing whitespace/newlines */
+    while (size > 0 && (buf[size - 1] == '\n' || buf[size - 1] == '\r' ||
+                        buf[size - 1] == ' ' || buf[size - 1] == '\t')) {
+        buf[--size] = '\0';
+    }
+    return buf;
+}
+
+static int parse_args(int argc, char** argv, bench_config* cfg) {
+    cfg->dsn = getenv("PGDSN") ? getenv("PGDSN") : DEFAULT_DSN;
+    cfg->query = NULL;
+    cfg->total_queries = 1000000;
+    cfg->batch_size = 1000;
+    cfg->warmup = 10000;
+    cfg->connections = 1;
+    cfg->sample = 0;
+    cfg->mem_interval = 0;
+    cfg->result_format = 0;
+    cfg->compare_formats = 0;
+    cfg->wide_rows = 0;
+    cfg->format = OUT_TEXT;
+    int n_given = 0;
+    int w_given = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* val = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "-h") == 0 || strcmp(arg, "--help") == 0) {
+            usage(argv[0]);
+            return -1;
+        }
+        if (val == NULL) {
+            fprintf(stderr, "Missing value for %s\n", arg);
+            return -1;
+        }
+
+        if (strcmp(arg, "-d") == 0) {
+            cfg->dsn = val;
+        } else if (strcmp(arg, "-q") == 0) {
+            free(cfg->query);
+            cfg->query = strdup(val);
+        } else if (strcmp(arg, "-f") == 0) {
+            free(cfg->query);
+            cfg->query = load_query_file(val);
+            if (cfg->query == NULL) return -1;
+        } else if (strcmp(arg, "-n") == 0) {
+            cfg->total_queries = atol(val);
+            n_given = 1;
+        } else if (strcmp(arg, "-b") == 0) {
+            cfg->batch_size = atoi(val);
+        } else if (strcmp(arg, "-w") == 0) {
+            cfg->warmup = atol(val);
+            w_given = 1;
+        } else if (strcmp(arg, "-j") == 0) {
+            cfg->connections = atoi(val);
+        } else if (strcmp(arg, "-s") == 0) {
+            cfg->sample = atol(val);
+        } else if (strcmp(arg, "-m") == 0) {
+            cfg->mem_interval = atoi(val);
+        } else if (strcmp(arg, "-F") == 0) {
+            if (strcmp(val, "text") == 0) cfg->result_format = 0;
+            else if (strcmp(val, "binary") == 0) cfg->result_format = 1;
+            else if (strcmp(val, "both") == 0) cfg->compare_formats = 1;
+            else {
+                fprintf(stderr, "Unknown result format: %s\n", val);
+                return -1;
+            }
+        } else if (strcmp(arg, "-W") == 0) {
+            cfg->wide_rows = atol(val);
+            if (cfg->wide_rows <= 0) {
+                fprintf(stderr, "Wide-mode row count must be positive\n");
+                return -1;
+            }
+        } else if (strcmp(arg, "-o") == 0) {
+            if (strcmp(val, "text") == 0) cfg->format = OUT_TEXT;
+            else if (strcmp(val, "csv") == 0) cfg->format = OUT_CSV;
+            else if (strcmp(val, "json") == 0) cfg->format = OUT_JSON;
+            else {
+                fprintf(stderr, "Unknown output format: %s\n", val);
+                return -1;
+            }
+        } else {
+            fprintf(stderr, "Unknown option: %s\n", arg);
+            usage(argv[0]);
+            return -1;
+        }
+        i++;
+    }
+
+    if (cfg->query == NULL) {
+        cfg->query = strdup(cfg->wide_rows > 0 ? WIDE_QUERY : DEFAULT_QUERY);
+    }
+    /* Wide mode moves the work into each result, so scale the query-count
+     * defaults down unless the caller set their own. */
+    if (cfg->wide_rows > 0 && !n_given) cfg->total_queries = 10000;
+    if (cfg->wide_rows > 0 && !w_given) cfg->warmup = 100;
+    if (cfg->total_queries <= 0 || cfg->batch_size <= 0 || cfg->warmup < 0 ||
+        cfg->connections <= 0) {
+        fprintf(stderr, "Counts must be positive\n");
+        return -1;
+    }
+    return 0;
+}
+
+/* Run `count` queries through the pipeline in batches.
+ * batch_hist/query_hist may be NULL (warmup runs are not measured).
+ * Returns 0 on success and fills *result. */
+static int run_pipeline(PGconn* conn, const bench_config* cfg, long count,
+                        int has_param, int report, latency_hist* batch_hist,
+                        latency_hist* query_hist, bench_result* result) {
+    long batches = (count + cfg->batch_size - 1) / cfg->batch_size;
+    long sent_total = 0;
+    long successful = 0;
+    long rows = 0;
+    long bytes = 0;
+
+    /* Send timestamps of sampled queries within the current batch */
+    double* send_ts = NULL;
+    if (query_hist != NULL && cfg->sample > 0) {
+        send_ts = malloc(cfg->batch_size * sizeof(double));
+    }
+
+    double start = get_time_ms();
+    double last_report = start;
+
+    if (PQenterPipelineMode(conn) == 0) {
+        fprintf(stderr, "Failed to enter pipeline mode\n");
+        free(send_ts);
+        return 1;
+    }
+
+    for (long batch = 0; batch < batches; batch++) {
+        int in_batch = cfg->batch_size;
+        if (sent_total + in_batch > count) {
+            in_batch = (int)(count - sent_total);
+        }
+
+        double batch_start = get_time_ms();
+
+        /* Send batch of queries */
+        for (int i = 0; i < in_batch; i++) {
+            char param[24];
+            snprintf(param, sizeof(param), "%ld",
+                     cfg->wide_rows > 0 ? cfg->wide_rows
+                                        : (sent_total + i) % 10 + 1);
+            const char* paramValues[1] = {param};
+
+            if (send_ts != NULL) {
+                send_ts[i] = (sent_total + i) % cfg->sample == 0
+                                 ? get_time_ms()
+                                 : -1.0;
+            }
+
+            if (PQsendQueryPrepared(conn, "stmt1", has_param ? 1 : 0,
+                                    has_param ? paramValues : NULL,
+                                    NULL, NULL, cfg->result_format) == 0) {
+                fprintf(stderr, "Send failed: %s\n", PQerrorMessage(conn));
+                break;
+            }
+        }
+        sent_total += in_batch;
+
+        /* Sync to flush pipeline */
+        PQpipelineSync(conn);
+
+        /* Consume results */
+        for (int i = 0; i < in_batch; i++) {
+            PGresult* res = PQgetResult(conn);
+            if (res == NULL) break;
+
+            if (PQresultStatus(res) == PGRES_TUPLES_OK) {
+                rows += decode_result(res, cfg->result_format, &bytes);
+                successful++;
+            } else if (PQresultStatus(res) == PGRES_COMMAND_OK) {
+                successful++;
+            }
+            PQclear(res);
+
+            if (send_ts != NULL && send_ts[i] >= 0.0) {
+                hist_record(query_hist, (get_time_ms() - send_ts[i]) * 1000.0);
+            }
+
+            /* Consume the NULL result that marks end of command */
+            res = PQgetResult(conn);
+            if (res) PQclear(res);
+        }
+
+        /* Consume pipeline sync result */
+        PGresult* res = PQgetResult(conn);
+        if (res) PQclear(res);
+
+        if (batch_hist != NULL) {
+            hist_record(batch_hist, (get_time_ms() - batch_start) * 1000.0);
+        }
+
+        /* Progress report */
+        double now = get_time_ms();
+        if (report && (now - last_report) >= 5000) {
+            double elapsed = (now - start) / 1000.0;
+            double qps = successful / elapsed;
+            double eta = (count - successful) / qps;
+            fprintf(stderr, "   Batch %ld/%ld: %.0f q/s | ETA: %.0fs\n",
+                    batch + 1, batches, qps, eta);
+            last_report = now;
+        }
+    }
+
+    PQexitPipelineMode(conn);
+    free(send_ts);
+    if (batch_hist != NULL) hist_flush(batch_hist);
+    if (query_hist != NULL) hist_flush(query_hist);
+
+    result->queries = count;
+    result->successful = successful;
+    result->rows = rows;
+    result->bytes = bytes;
+    result->elapsed_s = (get_time_ms() - start) / 1000.0;
+    return 0;
+}
+
+/* One worker per connection: each thread owns a PGconn and pushes its
+ * share of the queries through an independent pipeline. */
+typedef struct bench_worker {
+    const bench_config* cfg;
+    int                 id;
+    long                queries;  /* this worker's share */
+    long                warmup;
+    int                 has_param;
+    int                 report;
+    int                 failed;
+    bench_result        result;
+    latency_hist        batch_hist;
+    latency_hist        query_hist;
+    pthread_t           thread;
+} bench_worker;
+
+static void* worker_main(void* arg) {
+    bench_worker* w = (bench_worker*)arg;
+    const bench_config* cfg = w->cfg;
+    w->failed = 1;
+
+    PGconn* conn = PQconnectdb(cfg->dsn);
+    if (PQstatus(conn) != CONNECTION_OK) {
+        fprintf(stderr, "Connection %d failed: %s\n", w->id, PQerrorMessage(conn));
+        PQfinish(conn);
+        return NULL;
+    }
+
+    PGresult* res = PQprepare(conn, "stmt1", cfg->query, w->has_param ? 1 : 0, NULL);
+    if (PQresultStatus(res) != PGRES_COMMAND_OK) {
+        fprintf(stderr, "Prepare on connection %d failed: %s\n",
+                w->id, PQerrorMessage(conn));
+        PQclear(res);
+        PQfinish(conn);
+        return NULL;
+    }
+    PQclear(res);
+
+    /* Warmup: same pipeline, results discarded */
+    bench_result discard;
+    if (w->warmup > 0 &&
+        run_pipeline(conn, cfg, w->warmup, w->has_param, 0, NULL, NULL,
+                     &discard) != 0) {
+        PQfinish(conn);
+        return NULL;
+    }
+
+    if (run_pipeline(conn, cfg, w->queries, w->has_param, w->report,
+                     &w->batch_hist, cfg->sample > 0 ? &w->query_hist : NULL,
+                     &w->result) != 0) {
+        PQfinish(conn);
+        return NULL;
+    }
+
+    w->failed = 0;
+    PQfinish(conn);
+    return NULL;
+}
+
+static void print_hist_text(const char* label, const latency_hist* h) {
+    printf("│ %-10s p50 %8.0fus  p90 %8.0fus    │\n", label,
+           hist_percentile(h, 50), hist_percentile(h, 90));
+    printf("│ %-10s p99 %8.0fus  p99.9 %6.0fus    │\n", "",
+           hist_percentile(h, 99), hist_percentile(h, 99.9));
+    printf("│ %-10s max %8.0fus                  │\n", "", h->max_us);
+}
+
+static void print_hist_csv(const char* label, const latency_hist* h) {
+    printf("%s,%.0f,%.0f,%.0f,%.0f,%.0f\n", label, hist_percentile(h, 50),
+           hist_percentile(h, 90), hist_percentile(h, 99),
+           hist_percentile(h, 99.9), h->max_us);
+}
+
+static void print_hist_json(const latency_hist* h) {
+    printf("{\"p50_us\":%.0f,\"p90_us\":%.0f,\"p99_us\":%.0f,"
+           "\"p999_us\":%.0f,\"max_us\":%.0f,\"samples\":%ld}",
+           hist_percentile(h, 50), hist_percentile(h, 90),
+           hist_percentile(h, 99), hist_percentile(h, 99.9), h->max_us,
+           h->total);
+}
+
+static void print_result(const bench_config* cfg, const bench_worker* workers,
+                         const bench_result* sum, double wall_s,
+                         const latency_hist* batch_hist,
+                         const latency_hist* query_hist,
+                         const mem_summary* mem) {
+    long total = sum->queries;
+    long successful = sum->successful;
+    double qps = total / wall_s;
+    double per_query_ns = (wall_s * 1000000000.0) / total;
+    double rows_s = sum->rows / wall_s;
+    double mb_s = sum->bytes / (1024.0 * 1024.0) / wall_s;
+
+    switch (cfg->format) {
+        case OUT_CSV:
+            printf("connection,queries,successful,elapsed_s,qps\n");
+            for (int i = 0; i < cfg->connections; i++) {
+                const bench_result* r = &workers[i].result;
+                printf("%d,%ld,%ld,%.3f,%.0f\n", i, r->queries, r->successful,
+                       r->elapsed_s, r->queries / r->elapsed_s);
+            }
+            printf("total,%ld,%ld,%.3f,%.0f\n", total, successful, wall_s, qps);
+            if (sum->rows > 0) {
+                printf("decode,rows,bytes,rows_per_sec,mb_per_sec\n");
+                printf("decode,%ld,%ld,%.0f,%.1f\n", sum->rows, sum->bytes,
+                       rows_s, mb_s);
+            }
+            printf("latency,p50_us,p90_us,p99_us,p999_us,max_us\n");
+            print_hist_csv("batch", batch_hist);
+            if (query_hist->total > 0) print_hist_csv("query", query_hist);
+            if (mem != NULL) {
+                printf("memory,peak_kb,steady_kb,end_kb,end_heap_kb,monotonic\n");
+                printf("memory,%ld,%ld,%ld,%ld,%d\n", mem->peak_kb,
+                       mem->steady_kb, mem->end_kb, mem->end_heap_kb,
+                       mem->monotonic);
+            }
+            break;
+        case OUT_JSON:
+            printf("{\"connections\":[");
+            for (int i = 0; i < cfg->connections; i++) {
+                const bench_result* r = &workers[i].result;
+                printf("%s{\"queries\":%ld,\"successful\":%ld,\"elapsed_s\":%.3f,"
+                       "\"qps\":%.0f}",
+                       i > 0 ? "," : "", r->queries, r->successful,
+                       r->elapsed_s, r->queries / r->elapsed_s);
+            }
+            printf("],\"queries\":%ld,\"successful\":%ld,\"elapsed_s\":%.3f,"
+                   "\"qps\":%.0f,\"per_query_ns\":%.0f,\"batch_size\":%d,",
+                   total, successful, wall_s, qps, per_query_ns,
+                   cfg->batch_size);
+            if (sum->rows > 0) {
+                printf("\"rows\":%ld,\"bytes\":%ld,\"rows_per_sec\":%.0f,"
+                       "\"mb_per_sec\":%.1f,",
+                       sum->rows, sum->bytes, rows_s, mb_s);
+            }
+            printf("\"batch_latency\":");
+            print_hist_json(batch_hist);
+            if (query_hist->total > 0) {
+                printf(",\"query_latency\":");
+                print_hist_json(query_hist);
+            }
+            if (mem != NULL) {
+                printf(",\"memory\":{\"peak_kb\":%ld,\"steady_kb\":%ld,"
+                       "\"end_kb\":%ld,\"end_heap_kb\":%ld,\"monotonic\":%s}",
+                       mem->peak_kb, mem->steady_kb, mem->end_kb,
+                       mem->end_heap_kb, mem->monotonic ? "true" : "false");
+            }
+            printf("}\n");
+            break;
+        case OUT_TEXT:
+        default:
+            printf("\n📈 FINAL RESULTS:\n");
+            printf("┌──────────────────────────────────────────┐\n");
+            printf("│ LIBPQ BENCHMARK                          │\n");
+            printf("├──────────────────────────────────────────┤\n");
+            if (cfg->connections > 1) {
+                for (int i = 0; i < cfg->connections; i++) {
+                    const bench_result* r = &workers[i].result;
+                    printf("│ Conn %2d:           %16.0f q/s │\n",
+                           i, r->queries / r->elapsed_s);
+                }
+                printf("├──────────────────────────────────────────┤\n");
+            }
+            printf("│ Queries:           %20ld │\n", total);
+            printf("│ Connections:       %20d │\n", cfg->connections);
+            printf("│ Total Time:        %20.1fs │\n", wall_s);
+            printf("│ Queries/Second:    %20.0f │\n", qps);
+            printf("│ Per Query:         %17.0fns │\n", per_query_ns);
+            printf("│ Successful:        %20ld │\n", successful);
+            if (sum->rows > 0) {
+                printf("├──────────────────────────────────────────┤\n");
+                printf("│ Rows Decoded:      %20ld │\n", sum->rows);
+                printf("│ Rows/Second:       %20.0f │\n", rows_s);
+                printf("│ Decode Throughput: %16.1fMB/s │\n", mb_s);
+            }
+            printf("├──────────────────────────────────────────┤\n");
+            print_hist_text("Batch:", batch_hist);
+            if (query_hist->total > 0) {
+                print_hist_text("Query:", query_hist);
+            }
+            if (mem != NULL) {
+                printf("├──────────────────────────────────────────┤\n");
+                printf("│ Peak RSS (VmHWM):  %18ldKB │\n", mem->peak_kb);
+                printf("│ Steady RSS:        %18ldKB │\n", mem->steady_kb);
+                printf("│ Final RSS:         %18ldKB │\n", mem->end_kb);
+                if (mem->end_heap_kb >= 0) {
+                    printf("│ Heap In Use:       %18ldKB │\n",
+                           mem->end_heap_kb);
+                }
+                printf("│ Monotonic Growth:  %20s │\n",
+                       mem->monotonic ? "⚠️ YES" : "no");
+            }
+            printf("└──────────────────────────────────────────┘\n");
+            break;
+    }
+}
+
+/* One full measurement pass: spawn the workers, wait for them, and merge
+ * their results. Returns 0 on success; the caller owns *out_workers. */
+static int run_bench_pass(const bench_config* cfg, int has_param, int verbose,
+                          bench_result* out_sum, double* out_wall_s,
+                          latency_hist* batch_hist, latency_hist* query_hist,
+                          bench_worker** out_workers) {
+    int n = cfg->connections;
+    bench_worker* workers = calloc(n, sizeof(bench_worker));
+    for (int i = 0; i < n; i++) {
+        workers[i].cfg = cfg;
+        workers[i].id = i;
+        /* Spread the totals evenly; the first workers absorb the remainder */
+        workers[i].queries = cfg->total_queries / n +
+                             (i < cfg->total_queries % n ? 1 : 0);
+        workers[i].warmup = cfg->warmup / n + (i < cfg->warmup % n ? 1 : 0);
+        workers[i].has_param = has_param;
+        workers[i].report = verbose && i == 0;
+    }
+
+    if (verbose) {
+        printf("📊 Executing %ld queries over %d connection%s (%s results)...\n\n",
+               cfg->total_queries, n, n > 1 ? "s" : "",
+               cfg->result_format ? "binary" : "text");
+    }
+
+    double wall_start = get_time_ms();
+    for (int i = 0; i < n; i++) {
+        if (pthread_create(&workers[i].thread, NULL, worker_main, &workers[i]) != 0) {
+            fprintf(stderr, "Failed to spawn worker %d\n", i);
+            free(workers);
+            return 1;
+        }
+    }
+
+    memset(out_sum, 0, sizeof(*out_sum));
+    int failed = 0;
+    for (int i = 0; i < n; i++) {
+        pthread_join(workers[i].thread, NULL);
+        if (workers[i].failed) {
+            failed = 1;
+        } else {
+            out_sum->queries += workers[i].result.queries;
+            out_sum->successful += workers[i].result.successful;
+            out_sum->rows += workers[i].result.rows;
+            out_sum->bytes += workers[i].result.bytes;
+            hist_merge(batch_hist, &workers[i].batch_hist);
+            hist_merge(query_hist, &workers[i].query_hist);
+        }
+    }
+    *out_wall_s = (get_time_ms() - wall_start) / 1000.0;
+    out_sum->elapsed_s = *out_wall_s;
+    *out_workers = workers;
+
+    if (failed || out_sum->queries == 0) {
+        fprintf(stderr, "One or more connections failed\n");
+        return 1;
+    }
+    return 0;
+}
+
+/* Side-by-side text-vs-binary report for -F both. Decode rates are
+ * included when the runs returned rows (always in wide mode). */
+static void print_compare(const bench_config* cfg, const bench_result* text_sum,
+                          double text_wall, const bench_result* binary_sum,
+                          double binary_wall, const latency_hist* text_hist,
+                          const latency_hist* binary_hist) {
+    double text_qps = text_sum->queries / text_wall;
+    double binary_qps = binary_sum->queries / binary_wall;
+    double delta = (binary_qps - text_qps) / text_qps * 100.0;
+    double text_mb_s = text_sum->bytes / (1024.0 * 1024.0) / text_wall;
+    double binary_mb_s = binary_sum->bytes / (1024.0 * 1024.0) / binary_wall;
+    int decoded = text_sum->rows > 0 && binary_sum->rows > 0;
+
+    switch (cfg->format) {
+        case OUT_CSV:
+            printf("format,qps,rows_per_sec,mb_per_sec,p50_us,p99_us\n");
+            printf("text,%.0f,%.0f,%.1f,%.0f,%.0f\n", text_qps,
+                   text_sum->rows / text_wall, text_mb_s,
+                   hist_percentile(text_hist, 50),
+                   hist_percentile(text_hist, 99));
+            printf("binary,%.0f,%.0f,%.1f,%.0f,%.0f\n", binary_qps,
+                   binary_sum->rows / binary_wall, binary_mb_s,
+                   hist_percentile(binary_hist, 50),
+                   hist_percentile(binary_hist, 99));
+            printf("delta_pct,%.1f,,,,\n", delta);
+            break;
+        case OUT_JSON:
+            printf("{\"text\":{\"qps\":%.0f,\"rows_per_sec\":%.0f,"
+                   "\"mb_per_sec\":%.1f,\"batch_latency\":",
+                   text_qps, text_sum->rows / text_wall, text_mb_s);
+            print_hist_json(text_hist);
+            printf("},\"binary\":{\"qps\":%.0f,\"rows_per_sec\":%.0f,"
+                   "\"mb_per_sec\":%.1f,\"batch_latency\":",
+                   binary_qps, binary_sum->rows / binary_wall, binary_mb_s);
+            print_hist_json(binary_hist);
+            printf("},\"binary_delta_pct\":%.1f}\n", delta);
+            break;
+        case OUT_TEXT:
+        default:
+            printf("\n📈 TEXT vs BINARY RESULTS:\n");
+            printf("┌──────────────────────────────────────────┐\n");
+            printf("│ Text:              %16.0f q/s │\n", text_qps);
+            printf("│ Binary:            %16.0f q/s │\n", binary_qps);
+            printf("│ Binary vs Text:    %+18.1f%% │\n", delta);
+            if (decoded) {
+                printf("├──────────────────────────────────────────┤\n");
+                printf("│ Text Decode:       %16.1fMB/s │\n", text_mb_s);
+                printf("│ Binary Decode:     %16.1fMB/s │\n", binary_mb_s);
+            }
+            printf("├──────────────────────────────────────────┤\n");
+            print_hist_text("Text:", text_hist);
+            print_hist_text("Binary:", binary_hist);
+            printf("└──────────────────────────────────────────┘\n");
+            break;
+    }
+}
+
+int main(int argc, char** argv) {
+    bench_config cfg;
+    if (parse_args(argc, argv, &cfg) != 0) {
+        return 1;
+    }
+
+    int verbose = (cfg.format == OUT_TEXT);
+    if (verbose) {
+        printf("🔧 LIBPQ BENCHMARK HARNESS\n");
+        printf("==========================\n");
+        printf("Query:            %s\n", cfg.query);
+        printf("Total queries:    %15ld\n", cfg.total_queries);
+        printf("Batch size:       %15d\n", cfg.batch_size);
+        printf("Warmup:           %15ld\n", cfg.warmup);
+        printf("Connections:      %15d\n", cfg.connections);
+        if (cfg.wide_rows > 0) {
+            printf("Rows per query:   %15ld\n", cfg.wide_rows);
+        }
+        if (!cfg.compare_formats) {
+            printf("Result format:    %15s\n",
+                   cfg.result_format ? "binary" : "text");
+        }
+        printf("\n");
+    }
+
+    int has_param = strstr(cfg.query, "$1") != NULL;
+
+    mem_telemetry* mt = NULL;
+    if (cfg.mem_interval > 0) {
+        mt = calloc(1, sizeof(mem_telemetry));
+        mem_telemetry_start(mt, cfg.mem_interval);
+    }
+
+    int rc = 1;
+    latency_hist* batch_hist = calloc(1, sizeof(latency_hist));
+    latency_hist* query_hist = calloc(1, sizeof(latency_hist));
+
+    if (cfg.compare_formats) {
+        /* Two identical passes: text results first, then binary. */
+        bench_result text_sum, binary_sum;
+        double text_wall, binary_wall;
+        bench_worker* workers = NULL;
+        latency_hist* binary_batch = calloc(1, sizeof(latency_hist));
+        latency_hist* binary_query = calloc(1, sizeof(latency_hist));
+
+        cfg.result_format = 0;
+        if (run_bench_pass(&cfg, has_param, verbose, &text_sum, &text_wall,
+                           batch_hist, query_hist, &workers) == 0) {
+            free(workers);
+            workers = NULL;
+            cfg.result_format = 1;
+            if (run_bench_pass(&cfg, has_param, verbose, &binary_sum,
+                               &binary_wall, binary_batch, binary_query,
+                               &workers) == 0) {
+                print_compare(&cfg, &text_sum, text_wall, &binary_sum,
+                              binary_wall, batch_hist, binary_batch);
+                rc = 0;
+            }
+        }
+        free(workers);
+        free(binary_batch);
+        free(binary_query);
+    } else {
+        bench_result sum;
+        double wall_s;
+        bench_worker* workers = NULL;
+        if (run_bench_pass(&cfg, has_param, verbose, &sum, &wall_s,
+                           batch_hist, query_hist, &workers) == 0) {
+            mem_summary mem;
+            if (mt != NULL) {
+                mem_telemetry_stop(mt);
+                mem_summarize(mt, &mem);
+                free(mt);
+                mt = NULL;
+            }
+            print_result(&cfg, workers, &sum, wall_s, batch_hist,
+                         query_hist, cfg.mem_interval > 0 ? &mem : NULL);
+            rc = 0;
+        }
+        free(workers);
+    }
+
+    if (mt != NULL) {
+        mem_telemetry_stop(mt);
+        free(mt);
+    }
+    free(batch_hist);
+    free(query_hist);
+    free(cfg.query);
+    return rc;
+}
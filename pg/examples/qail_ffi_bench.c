@@ -0,0 +1,380 @@
+/*
+ * QAIL FFI BENCHMARK - C API end-to-end over libpq
+ *
+ * Measures the path the PHP/Go services actually take: queries are
+ * generated through the C API in ffi/include/qail.h and pushed through
+ * the same million-query pipeline as the raw-libpq baseline, all in one
+ * binary so the FFI overhead shows up as a direct delta.
+ *
+ * Three modes (-M, default runs all three):
+ *   libpq      prepared statement via PQsendQueryPrepared (baseline)
+ *   transpile  qail_transpile() -> SQL text -> PQsendQueryParams
+ *   encode     qail_encode_batch_get() -> wire bytes written straight
+ *              to the socket, responses parsed raw (no SQL text at all)
+ *
+ * The encode mode takes over the connection's socket after libpq has
+ * authenticated it, so it requires a non-SSL connection.
+ *
+ * Build: make qail_ffi_bench   (builds the Rust staticlib first)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <libpq-fe.h>
+#include <qail.h>
+
+#define DEFAULT_DSN     "host=127.0.0.1 port=5432 user=postgres dbname=postgres"
+#define DEFAULT_TABLE   "harbors"
+#define DEFAULT_COLUMNS "id, name"
+
+typedef struct ffi_config {
+    const char* dsn;
+    const char* table;
+    const char* columns;
+    long        total_queries;
+    int         batch_size;
+    long        warmup;
+    const char* mode;  /* "all", "libpq", "transpile" or "encode" */
+} ffi_config;
+
+static double get_time_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  -d DSN    connection string (default: \"%s\")\n"
+            "  -t TABLE  table to query (default: %s)\n"
+            "  -c COLS   column list (default: \"%s\")\n"
+            "  -n COUNT  total queries per mode (default 1000000)\n"
+            "  -b SIZE   pipeline batch size (default 1000)\n"
+            "  -w COUNT  warmup queries per mode (default 10000)\n"
+            "  -M MODE   all, libpq, transpile or encode (default all)\n",
+            prog, DEFAULT_DSN, DEFAULT_TABLE, DEFAULT_COLUMNS);
+}
+
+/* ------------------------------------------------------------------ */
+/* libpq baseline: prepared statement, pipelined                       */
+/* ------------------------------------------------------------------ */
+
+static long run_libpq(PGconn* conn, const ffi_config* cfg, long count) {
+    long successful = 0;
+    long sent_total = 0;
+    long batches = (count + cfg->batch_size - 1) / cfg->batch_size;
+
+    PQenterPipelineMode(conn);
+    for (long batch = 0; batch < batches; batch++) {
+        int in_batch = cfg->batch_size;
+        if (sent_total + in_batch > count) in_batch = (int)(count - sent_total);
+
+        for (int i = 0; i < in_batch; i++) {
+            char param[16];
+            snprintf(param, sizeof(param), "%ld", (sent_total + i) % 10 + 1);
+            const char* paramValues[1] = {param};
+            PQsendQueryPrepared(conn, "stmt1", 1, paramValues, NULL, NULL, 0);
+        }
+        sent_total += in_batch;
+        PQpipelineSync(conn);
+
+        for (int i = 0; i < in_batch; i++) {
+            PGresult* res = PQgetResult(conn);
+            if (res == NULL) break;
+            if (PQresultStatus(res) == PGRES_TUPLES_OK) successful++;
+            PQclear(res);
+            res = PQgetResult(conn);
+            if (res) PQclear(res);
+        }
+        PGresult* res = PQgetResult(conn);
+        if (res) PQclear(res);
+    }
+    PQexitPipelineMode(conn);
+    return successful;
+}
+
+/* ------------------------------------------------------------------ */
+/* transpile mode: QAIL text -> qail_transpile -> SQL -> pipeline      */
+/* ------------------------------------------------------------------ */
+
+static long run_transpile(PGconn* conn, const ffi_config* cfg, long count) {
+    long successful = 0;
+    long sent_total = 0;
+    long batches = (count + cfg->batch_size - 1) / cfg->batch_size;
+
+    PQenterPipelineMode(conn);
+    for (long batch = 0; batch < batches; batch++) {
+        int in_batch = cfg->batch_size;
+        if (sent_total + in_batch > count) in_batch = (int)(count - sent_total);
+
+        for (int i = 0; i < in_batch; i++) {
+            char qail[256];
+            snprintf(qail, sizeof(qail), "get %s fields %s limit %ld",
+                     cfg->table, cfg->columns, (sent_total + i) % 10 + 1);
+            char* sql = qail_transpile(qail);
+            if (sql == NULL) {
+                fprintf(stderr, "Transpile failed: %s\n", qail_last_error());
+                continue;
+            }
+            PQsendQueryParams(conn, sql, 0, NULL, NULL, NULL, NULL, 0);
+            qail_free(sql);
+        }
+        sent_total += in_batch;
+        PQpipelineSync(conn);
+
+        for (int i = 0; i < in_batch; i++) {
+            PGresult* res = PQgetResult(conn);
+            if (res == NULL) break;
+            if (PQresultStatus(res) == PGRES_TUPLES_OK) successful++;
+            PQclear(res);
+            res = PQgetResult(conn);
+            if (res) PQclear(res);
+        }
+        PGresult* res = PQgetResult(conn);
+        if (res) PQclear(res);
+    }
+    PQexitPipelineMode(conn);
+    return successful;
+}
+
+/* ------------------------------------------------------------------ */
+/* encode mode: qail_encode_batch_get -> raw socket write/read         */
+/* ------------------------------------------------------------------ */
+
+/* Drain one pipeline batch of raw protocol frames from the socket,
+ * counting CommandComplete ('C') per query. Stops after ReadyForQuery
+ * ('Z'), which follows the batch's Sync. Returns successes, -1 on I/O
+ * error. */
+static long drain_raw_batch(int fd) {
+    static char buf[65536];
+    static int have = 0;
+    long successful = 0;
+
+    for (;;) {
+        /* Ensure a full frame header: 1 byte type + 4 byte length */
+        while (have < 5) {
+            ssize_t n = read(fd, buf + have, sizeof(buf) - have);
+            if (n <= 0) return -1;
+            have += (int)n;
+        }
+        char type = buf[0];
+        int len = ((unsigned char)buf[1] << 24) | ((unsigned char)buf[2] << 16) |
+                  ((unsigned char)buf[3] << 8) | (unsigned char)buf[4];
+        int frame = 1 + len;  /* length includes itself but not the type */
+
+        while (have < frame) {
+            ssize_t n = read(fd, buf + have, sizeof(buf) - have);
+            if (n <= 0) return -1;
+            have += (int)n;
+        }
+
+        if (type == 'C') successful++;
+        else if (type == 'E') {
+            fprintf(stderr, "Server error in encode mode\n");
+        }
+
+        memmove(buf, buf + frame, have - frame);
+        have -= frame;
+
+        if (type == 'Z') return successful;
+    }
+}
+
+static long run_encode(PGconn* conn, const ffi_config* cfg, long count) {
+    long successful = 0;
+    long sent_total = 0;
+    long batches = (count + cfg->batch_size - 1) / cfg->batch_size;
+    int fd = PQsocket(conn);
+
+    const char** tables = malloc(cfg->batch_size * sizeof(char*));
+    const char** columns = malloc(cfg->batch_size * sizeof(char*));
+    int64_t* limits = malloc(cfg->batch_size * sizeof(int64_t));
+    for (int i = 0; i < cfg->batch_size; i++) {
+        tables[i] = cfg->table;
+        columns[i] = cfg->columns;
+    }
+
+    for (long batch = 0; batch < batches; batch++) {
+        int in_batch = cfg->batch_size;
+        if (sent_total + in_batch > count) in_batch = (int)(count - sent_total);
+
+        for (int i = 0; i < in_batch; i++) {
+            limits[i] = (sent_total + i) % 10 + 1;
+        }
+
+        uint8_t* bytes;
+        size_t len;
+        if (qail_encode_batch_get(tables, columns, limits, in_batch,
+                                  &bytes, &len) != 0) {
+            fprintf(stderr, "Encode failed: %s\n", qail_last_error());
+            break;
+        }
+
+        size_t off = 0;
+        while (off < len) {
+            ssize_t n = write(fd, bytes + off, len - off);
+            if (n <= 0) {
+                fprintf(stderr, "Socket write failed\n");
+                qail_free_bytes(bytes, len);
+                goto done;
+            }
+            off += (size_t)n;
+        }
+        qail_free_bytes(bytes, len);
+        sent_total += in_batch;
+
+        long got = drain_raw_batch(fd);
+        if (got < 0) {
+            fprintf(stderr, "Socket read failed\n");
+            break;
+        }
+        successful += got;
+    }
+
+done:
+    free(tables);
+    free(columns);
+    free(limits);
+    return successful;
+}
+
+/* ------------------------------------------------------------------ */
+
+typedef struct mode_result {
+    const char* name;
+    long        successful;
+    double      elapsed_s;
+    int         ran;
+} mode_result;
+
+static int run_mode(const ffi_config* cfg, mode_result* out,
+                    long (*run)(PGconn*, const ffi_config*, long),
+                    const char* name, int needs_prepare, int raw_socket) {
+    out->name = name;
+    out->ran = 0;
+
+    PGconn* conn = PQconnectdb(cfg->dsn);
+    if (PQstatus(conn) != CONNECTION_OK) {
+        fprintf(stderr, "Connection failed: %s\n", PQerrorMessage(conn));
+        PQfinish(conn);
+        return 1;
+    }
+
+    if (raw_socket && PQsslInUse(conn)) {
+        fprintf(stderr, "Encode mode needs a non-SSL connection "
+                        "(add sslmode=disable to the DSN)\n");
+        PQfinish(conn);
+        return 1;
+    }
+
+    if (needs_prepare) {
+        char sql[512];
+        snprintf(sql, sizeof(sql), "SELECT %s FROM %s LIMIT $1",
+                 cfg->columns, cfg->table);
+        PGresult* res = PQprepare(conn, "stmt1", sql, 1, NULL);
+        if (PQresultStatus(res) != PGRES_COMMAND_OK) {
+            fprintf(stderr, "Prepare failed: %s\n", PQerrorMessage(conn));
+            PQclear(res);
+            PQfinish(conn);
+            return 1;
+        }
+        PQclear(res);
+    }
+
+    printf("🔥 %s: warming up...\n", name);
+    if (cfg->warmup > 0) run(conn, cfg, cfg->warmup);
+
+    printf("📊 %s: executing %ld queries...\n", name, cfg->total_queries);
+    double start = get_time_ms();
+    out->successful = run(conn, cfg, cfg->total_queries);
+    out->elapsed_s = (get_time_ms() - start) / 1000.0;
+    out->ran = 1;
+
+    PQfinish(conn);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    ffi_config cfg = {
+        .dsn = getenv("PGDSN") ? getenv("PGDSN") : DEFAULT_DSN,
+        .table = DEFAULT_TABLE,
+        .columns = DEFAULT_COLUMNS,
+        .total_queries = 1000000,
+        .batch_size = 1000,
+        .warmup = 10000,
+        .mode = "all",
+    };
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* val = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (strcmp(arg, "-h") == 0 || strcmp(arg, "--help") == 0) {
+            usage(argv[0]);
+            return 1;
+        }
+        if (val == NULL) {
+            fprintf(stderr, "Missing value for %s\n", arg);
+            return 1;
+        }
+        if (strcmp(arg, "-d") == 0) cfg.dsn = val;
+        else if (strcmp(arg, "-t") == 0) cfg.table = val;
+        else if (strcmp(arg, "-c") == 0) cfg.columns = val;
+        else if (strcmp(arg, "-n") == 0) cfg.total_queries = atol(val);
+        else if (strcmp(arg, "-b") == 0) cfg.batch_size = atoi(val);
+        else if (strcmp(arg, "-w") == 0) cfg.warmup = atol(val);
+        else if (strcmp(arg, "-M") == 0) cfg.mode = val;
+        else {
+            fprintf(stderr, "Unknown option: %s\n", arg);
+            usage(argv[0]);
+            return 1;
+        }
+        i++;
+    }
+
+    printf("🔧 QAIL FFI BENCHMARK\n");
+    printf("=====================\n");
+    printf("Table:            %s (%s)\n", cfg.table, cfg.columns);
+    printf("Total queries:    %15ld per mode\n", cfg.total_queries);
+    printf("Batch size:       %15d\n\n", cfg.batch_size);
+
+    int all = strcmp(cfg.mode, "all") == 0;
+    mode_result results[3] = {0};
+
+    if ((all || strcmp(cfg.mode, "libpq") == 0) &&
+        run_mode(&cfg, &results[0], run_libpq, "libpq", 1, 0) != 0) {
+        return 1;
+    }
+    if ((all || strcmp(cfg.mode, "transpile") == 0) &&
+        run_mode(&cfg, &results[1], run_transpile, "transpile", 0, 0) != 0) {
+        return 1;
+    }
+    if ((all || strcmp(cfg.mode, "encode") == 0) &&
+        run_mode(&cfg, &results[2], run_encode, "encode", 0, 1) != 0) {
+        return 1;
+    }
+
+    double baseline_qps = 0.0;
+    printf("\n📈 FINAL RESULTS:\n");
+    printf("┌────────────┬──────────────┬──────────┬──────────┐\n");
+    printf("│ Mode       │          q/s │     Time │ vs libpq │\n");
+    printf("├────────────┼──────────────┼──────────┼──────────┤\n");
+    for (int i = 0; i < 3; i++) {
+        if (!results[i].ran) continue;
+        double qps = cfg.total_queries / results[i].elapsed_s;
+        if (i == 0) baseline_qps = qps;
+        if (baseline_qps > 0.0) {
+            printf("│ %-10s │ %12.0f │ %7.1fs │ %+7.1f%% │\n", results[i].name,
+                   qps, results[i].elapsed_s,
+                   (qps - baseline_qps) / baseline_qps * 100.0);
+        } else {
+            printf("│ %-10s │ %12.0f │ %7.1fs │      n/a │\n", results[i].name,
+                   qps, results[i].elapsed_s);
+        }
+    }
+    printf("└────────────┴──────────────┴──────────┴──────────┘\n");
+    return 0;
+}
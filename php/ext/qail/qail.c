@@ -13,6 +13,8 @@
 #include "php_ini.h"
 #include "ext/standard/info.h"
 
+#include <sys/mman.h>
+
 /* Rust FFI declarations (from libqail_php.a) */
 extern const char* qail_version(void);
 extern uint8_t* qail_encode_select(
@@ -28,10 +30,440 @@ extern uint8_t* qail_encode_batch(
     size_t count,
     size_t* out_len
 );
+extern uint8_t* qail_encode_query(
+    const char* table,
+    const char* columns,
+    const char** where_specs,
+    const uint8_t* param_types,
+    const int64_t* param_longs,
+    const double* param_doubles,
+    const char** param_strings,
+    size_t where_count,
+    int64_t limit,
+    size_t* out_len
+);
 extern void qail_bytes_free(uint8_t* ptr, size_t len);
+extern uint32_t qail_intern(const char* name);
+extern uint8_t* qail_encode_select_i(
+    uint32_t table_id,
+    const uint32_t* column_ids,
+    size_t column_count,
+    int64_t limit,
+    size_t* out_len
+);
+extern int qail_encode_select_into(
+    const char* table,
+    const char* columns,
+    int64_t limit,
+    uint8_t* buf,
+    size_t cap,
+    size_t* out_len
+);
+extern int qail_encode_batch_into(
+    const char* table,
+    const char* columns,
+    const int64_t* limits,
+    size_t count,
+    uint8_t* buf,
+    size_t cap,
+    size_t* out_len
+);
+extern int qail_transpile_into(
+    const char* qail_text,
+    uint8_t* buf,
+    size_t cap,
+    size_t* out_len
+);
+
+/* Opaque Rust connection handle */
+typedef struct QailConnection QailConnection;
+
+extern QailConnection* qail_connect(
+    const char* host,
+    uint16_t port,
+    const char* user,
+    const char* database
+);
+extern void qail_disconnect(QailConnection* conn);
+extern int64_t qail_exec_encoded(
+    QailConnection* conn,
+    const uint8_t* bytes,
+    size_t len,
+    size_t expected_queries
+);
+
+extern void qail_batch_parallel_threshold(size_t threshold);
+
+/* Typed parameter tags understood by qail_encode_query */
+#define QAIL_PARAM_NULL   0
+#define QAIL_PARAM_LONG   1
+#define QAIL_PARAM_DOUBLE 2
+#define QAIL_PARAM_STRING 3
+#define QAIL_PARAM_BOOL   4
 extern char* qail_transpile(const char* qail_text, size_t* out_len);
 extern void qail_string_free(char* ptr);
 
+/* PHP function: qail_batch_parallel_threshold(int $threshold)
+ *
+ * Batch size at which qail_encode_batch splits across worker threads
+ * inside the library; 0 keeps all encoding on the calling thread. */
+PHP_FUNCTION(qail_batch_parallel_threshold)
+{
+    zend_long threshold;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_LONG(threshold)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (threshold < 0) {
+        threshold = 0;
+    }
+    qail_batch_parallel_threshold((size_t)threshold);
+    RETURN_TRUE;
+}
+
+/* ==================== Shared-memory cross-worker cache ====================
+ *
+ * Opcache-style anonymous shared mapping created at MINIT — in PHP-FPM
+ * that happens in the master process, so every forked worker shares the
+ * segment. Slots are write-once (EMPTY -> WRITING -> READY, never back),
+ * which makes reads lock-free: a READY slot is immutable, so a reader
+ * needs only an acquire load and a memcpy. A query encoded by any worker
+ * is a cache hit for all of them, which matters most right after deploys
+ * when every cold worker hammers the encoder at once. */
+
+#define QAIL_SHM_SLOTS    1024
+#define QAIL_SHM_PROBES   4
+#define QAIL_SHM_KEY_MAX  192
+#define QAIL_SHM_DATA_MAX 1856
+
+#define QAIL_SHM_EMPTY    0u
+#define QAIL_SHM_WRITING  1u
+#define QAIL_SHM_READY    2u
+
+typedef struct qail_shm_slot {
+    uint32_t state;
+    uint32_t key_len;
+    uint32_t data_len;
+    uint32_t reserved;
+    uint64_t key_hash;
+    char     key[QAIL_SHM_KEY_MAX];
+    uint8_t  data[QAIL_SHM_DATA_MAX];
+} qail_shm_slot;
+
+typedef struct qail_shm_seg {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t inserts;
+    uint64_t rejected;  /* slot collisions and oversized entries */
+    qail_shm_slot slots[QAIL_SHM_SLOTS];
+} qail_shm_seg;
+
+static qail_shm_seg* qail_shm = NULL;
+
+static uint64_t qail_shm_hash(const char* key, size_t len)
+{
+    /* FNV-1a */
+    uint64_t h = 1469598103934665603ull;
+    for (size_t i = 0; i < len; i++) {
+        h ^= (uint8_t)key[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+/* Lock-free lookup. Returns the immutable slot data, or NULL on miss. */
+static const qail_shm_slot* qail_shm_lookup(const char* key, size_t key_len)
+{
+    if (qail_shm == NULL || key_len > QAIL_SHM_KEY_MAX) {
+        return NULL;
+    }
+
+    uint64_t hash = qail_shm_hash(key, key_len);
+    for (size_t probe = 0; probe < QAIL_SHM_PROBES; probe++) {
+        qail_shm_slot* slot = &qail_shm->slots[(hash + probe) % QAIL_SHM_SLOTS];
+        uint32_t state = __atomic_load_n(&slot->state, __ATOMIC_ACQUIRE);
+        if (state == QAIL_SHM_EMPTY) {
+            break;
+        }
+        if (state == QAIL_SHM_READY && slot->key_hash == hash &&
+            slot->key_len == key_len && memcmp(slot->key, key, key_len) == 0) {
+            __atomic_fetch_add(&qail_shm->hits, 1, __ATOMIC_RELAXED);
+            return slot;
+        }
+    }
+
+    __atomic_fetch_add(&qail_shm->misses, 1, __ATOMIC_RELAXED);
+    return NULL;
+}
+
+/* Publish an entry. Safe against concurrent writers via CAS on state. */
+static void qail_shm_insert(const char* key, size_t key_len,
+                            const uint8_t* data, size_t data_len)
+{
+    if (qail_shm == NULL || key_len > QAIL_SHM_KEY_MAX || data_len > QAIL_SHM_DATA_MAX) {
+        if (qail_shm != NULL) {
+            __atomic_fetch_add(&qail_shm->rejected, 1, __ATOMIC_RELAXED);
+        }
+        return;
+    }
+
+    uint64_t hash = qail_shm_hash(key, key_len);
+    for (size_t probe = 0; probe < QAIL_SHM_PROBES; probe++) {
+        qail_shm_slot* slot = &qail_shm->slots[(hash + probe) % QAIL_SHM_SLOTS];
+        uint32_t expected = QAIL_SHM_EMPTY;
+        if (__atomic_compare_exchange_n(&slot->state, &expected, QAIL_SHM_WRITING,
+                                        0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            slot->key_hash = hash;
+            slot->key_len = (uint32_t)key_len;
+            slot->data_len = (uint32_t)data_len;
+            memcpy(slot->key, key, key_len);
+            memcpy(slot->data, data, data_len);
+            __atomic_store_n(&slot->state, QAIL_SHM_READY, __ATOMIC_RELEASE);
+            __atomic_fetch_add(&qail_shm->inserts, 1, __ATOMIC_RELAXED);
+            return;
+        }
+        /* Occupied: another worker may have just published this key */
+        if (__atomic_load_n(&slot->state, __ATOMIC_ACQUIRE) == QAIL_SHM_READY &&
+            slot->key_hash == hash && slot->key_len == key_len &&
+            memcmp(slot->key, key, key_len) == 0) {
+            return;
+        }
+    }
+
+    __atomic_fetch_add(&qail_shm->rejected, 1, __ATOMIC_RELAXED);
+}
+
+/* PHP function: qail_shm_stats() */
+PHP_FUNCTION(qail_shm_stats)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    if (qail_shm == NULL) {
+        RETURN_FALSE;
+    }
+
+    array_init(return_value);
+    add_assoc_long(return_value, "slots", QAIL_SHM_SLOTS);
+    add_assoc_long(return_value, "hits",
+                   (zend_long)__atomic_load_n(&qail_shm->hits, __ATOMIC_RELAXED));
+    add_assoc_long(return_value, "misses",
+                   (zend_long)__atomic_load_n(&qail_shm->misses, __ATOMIC_RELAXED));
+    add_assoc_long(return_value, "inserts",
+                   (zend_long)__atomic_load_n(&qail_shm->inserts, __ATOMIC_RELAXED));
+    add_assoc_long(return_value, "rejected",
+                   (zend_long)__atomic_load_n(&qail_shm->rejected, __ATOMIC_RELAXED));
+}
+
+/* ==================== Persistent statement cache ====================
+ *
+ * Encoded query shapes survive across requests within a PHP-FPM worker.
+ * The table lives in persistent (malloc) memory, initialized at MINIT
+ * and destroyed at MSHUTDOWN, so steady-state encoding is a hash lookup
+ * instead of a full encode per request. */
+
+typedef struct qail_stmt_entry {
+    uint8_t* bytes;
+    size_t   len;
+} qail_stmt_entry;
+
+static HashTable qail_stmt_cache;
+
+static void qail_stmt_entry_dtor(zval* zv)
+{
+    qail_stmt_entry* entry = Z_PTR_P(zv);
+    pefree(entry->bytes, 1);
+    pefree(entry, 1);
+}
+
+/* PHP function: qail_stmt_encode(string $table, string $columns, int $limit)
+ *
+ * Like qail_encode_select, but the encoded wire bytes are compiled once
+ * per query shape and cached persistently for the worker's lifetime. */
+PHP_FUNCTION(qail_stmt_encode)
+{
+    char *table, *columns;
+    size_t table_len, columns_len;
+    zend_long limit = 0;
+
+    ZEND_PARSE_PARAMETERS_START(2, 3)
+        Z_PARAM_STRING(table, table_len)
+        Z_PARAM_STRING(columns, columns_len)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(limit)
+    ZEND_PARSE_PARAMETERS_END();
+
+    /* Fingerprint the query shape */
+    char key[512];
+    int key_len = snprintf(key, sizeof(key), "%s|%s|" ZEND_LONG_FMT,
+                           table, columns, limit);
+    if (key_len < 0 || (size_t)key_len >= sizeof(key)) {
+        php_error_docref(NULL, E_WARNING, "query shape too long to cache");
+        RETURN_FALSE;
+    }
+
+    qail_stmt_entry* entry = zend_hash_str_find_ptr(&qail_stmt_cache, key, key_len);
+    if (entry != NULL) {
+        RETURN_STRINGL((char*)entry->bytes, entry->len);
+    }
+
+    /* Not in this worker: maybe another worker already encoded it */
+    const qail_shm_slot* shared = qail_shm_lookup(key, (size_t)key_len);
+    size_t out_len = 0;
+    uint8_t* bytes = NULL;
+
+    if (shared != NULL) {
+        out_len = shared->data_len;
+    } else {
+        bytes = qail_encode_select(table, columns, (int64_t)limit, &out_len);
+        if (bytes == NULL || out_len == 0) {
+            RETURN_EMPTY_STRING();
+        }
+    }
+
+    /* Store a persistent copy; the Rust allocation is released here */
+    entry = pemalloc(sizeof(qail_stmt_entry), 1);
+    entry->bytes = pemalloc(out_len, 1);
+    entry->len = out_len;
+    if (shared != NULL) {
+        memcpy(entry->bytes, shared->data, out_len);
+    } else {
+        memcpy(entry->bytes, bytes, out_len);
+        qail_bytes_free(bytes, out_len);
+        /* Publish for the other workers in the pool */
+        qail_shm_insert(key, (size_t)key_len, entry->bytes, out_len);
+    }
+
+    zend_hash_str_add_ptr(&qail_stmt_cache, key, key_len, entry);
+
+    RETURN_STRINGL((char*)entry->bytes, entry->len);
+}
+
+/* PHP function: qail_stmt_cache_count() */
+PHP_FUNCTION(qail_stmt_cache_count)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+    RETURN_LONG((zend_long)zend_hash_num_elements(&qail_stmt_cache));
+}
+
+/* PHP function: qail_stmt_cache_clear() */
+PHP_FUNCTION(qail_stmt_cache_clear)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+    zend_hash_clean(&qail_stmt_cache);
+    RETURN_TRUE;
+}
+
+/* ==================== Persistent connection + pipelining ====================
+ *
+ * One PostgreSQL connection per PHP-FPM worker, established on first use
+ * and surviving across requests (released at MSHUTDOWN). Pre-encoded wire
+ * buffers are written to it in one batch and the responses are decoded in
+ * Rust, mirroring the pipeline pattern of pg/examples/million_libpq.c. */
+
+static QailConnection* qail_pconn = NULL;
+
+/* PHP function: qail_pconnect(string $host, int $port, string $user, string $db)
+ *
+ * Establishes (or reuses) the worker's persistent connection. */
+PHP_FUNCTION(qail_pconnect)
+{
+    char *host, *user, *db;
+    size_t host_len, user_len, db_len;
+    zend_long port;
+
+    ZEND_PARSE_PARAMETERS_START(4, 4)
+        Z_PARAM_STRING(host, host_len)
+        Z_PARAM_LONG(port)
+        Z_PARAM_STRING(user, user_len)
+        Z_PARAM_STRING(db, db_len)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (qail_pconn != NULL) {
+        RETURN_TRUE;
+    }
+
+    qail_pconn = qail_connect(host, (uint16_t)port, user, db);
+    if (qail_pconn == NULL) {
+        php_error_docref(NULL, E_WARNING, "connection to %s:%ld failed", host, (long)port);
+        RETURN_FALSE;
+    }
+
+    RETURN_TRUE;
+}
+
+/* PHP function: qail_pclose() */
+PHP_FUNCTION(qail_pclose)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    if (qail_pconn != NULL) {
+        qail_disconnect(qail_pconn);
+        qail_pconn = NULL;
+    }
+    RETURN_TRUE;
+}
+
+/* PHP function: qail_pipeline_exec(array $encoded, int $query_count = 0)
+ *
+ * Concatenates pre-encoded wire buffers (from qail_encode_select /
+ * qail_encode_query / qail_encode_batch) and executes them on the
+ * persistent connection in one write, with responses decoded in Rust.
+ * $query_count must be given when array entries hold multi-query batch
+ * encodings; it defaults to one query per entry.
+ * Returns the number of completed queries, or false on failure. */
+PHP_FUNCTION(qail_pipeline_exec)
+{
+    HashTable *encoded_ht;
+    zend_long query_count = 0;
+
+    ZEND_PARSE_PARAMETERS_START(1, 2)
+        Z_PARAM_ARRAY_HT(encoded_ht)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(query_count)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (qail_pconn == NULL) {
+        php_error_docref(NULL, E_WARNING, "no persistent connection; call qail_pconnect() first");
+        RETURN_FALSE;
+    }
+
+    size_t count = zend_hash_num_elements(encoded_ht);
+    if (count == 0) {
+        RETURN_LONG(0);
+    }
+
+    /* Concatenate the buffers for a single write on the Rust side */
+    size_t total = 0;
+    zval* val;
+    ZEND_HASH_FOREACH_VAL(encoded_ht, val) {
+        if (Z_TYPE_P(val) != IS_STRING) {
+            php_error_docref(NULL, E_WARNING, "encoded entries must be strings");
+            RETURN_FALSE;
+        }
+        total += Z_STRLEN_P(val);
+    } ZEND_HASH_FOREACH_END();
+
+    uint8_t* batch = emalloc(total);
+    size_t offset = 0;
+    ZEND_HASH_FOREACH_VAL(encoded_ht, val) {
+        memcpy(batch + offset, Z_STRVAL_P(val), Z_STRLEN_P(val));
+        offset += Z_STRLEN_P(val);
+    } ZEND_HASH_FOREACH_END();
+
+    if (query_count <= 0) {
+        query_count = (zend_long)count;
+    }
+
+    int64_t completed = qail_exec_encoded(qail_pconn, batch, total, (size_t)query_count);
+    efree(batch);
+
+    if (completed < 0) {
+        RETURN_FALSE;
+    }
+    RETURN_LONG((zend_long)completed);
+}
+
 /* PHP function: qail_version() */
 PHP_FUNCTION(qail_version)
 {
@@ -54,17 +486,221 @@ PHP_FUNCTION(qail_encode_select)
         Z_PARAM_OPTIONAL
         Z_PARAM_LONG(limit)
     ZEND_PARSE_PARAMETERS_END();
-    
+
+    /* Rust encodes straight into the zend_string payload: one allocation,
+     * no intermediate buffer, no copy. The reserve covers typical SELECT
+     * encodings; an undersized first call reports the exact size. */
+    size_t cap = 256;
+    zend_string* result = zend_string_alloc(cap, 0);
     size_t out_len = 0;
-    uint8_t* bytes = qail_encode_select(table, columns, (int64_t)limit, &out_len);
-    
+    int rc = qail_encode_select_into(table, columns, (int64_t)limit,
+                                     (uint8_t*)ZSTR_VAL(result), cap, &out_len);
+    if (rc == 1) {
+        zend_string_release(result);
+        cap = out_len;
+        result = zend_string_alloc(cap, 0);
+        rc = qail_encode_select_into(table, columns, (int64_t)limit,
+                                     (uint8_t*)ZSTR_VAL(result), cap, &out_len);
+    }
+
+    if (rc != 0 || out_len == 0) {
+        zend_string_release(result);
+        RETURN_EMPTY_STRING();
+    }
+
+    result = zend_string_truncate(result, out_len, 0);
+    ZSTR_VAL(result)[out_len] = '\0';
+
+    RETURN_NEW_STR(result);
+}
+
+/* PHP function: qail_intern(string $name): int
+ *
+ * Interns a table or column name once (typically at worker startup) and
+ * returns a stable id for qail_encode_select_i. Returns 0 for invalid
+ * names. Interning the same name twice returns the same id. */
+PHP_FUNCTION(qail_intern)
+{
+    char *name;
+    size_t name_len;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_STRING(name, name_len)
+    ZEND_PARSE_PARAMETERS_END();
+
+    RETURN_LONG((zend_long)qail_intern(name));
+}
+
+/* PHP function: qail_encode_select_i(int $table_id, array $column_ids,
+ *                                     int $limit): string
+ *
+ * Interned variant of qail_encode_select: identifiers were validated at
+ * qail_intern() time, so the steady-state encode path does no string
+ * handling at all. An empty $column_ids array selects all columns.
+ * Returns '' if any id was never interned. */
+PHP_FUNCTION(qail_encode_select_i)
+{
+    zend_long table_id;
+    HashTable *columns_ht = NULL;
+    zend_long limit = 0;
+
+    ZEND_PARSE_PARAMETERS_START(1, 3)
+        Z_PARAM_LONG(table_id)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_ARRAY_HT(columns_ht)
+        Z_PARAM_LONG(limit)
+    ZEND_PARSE_PARAMETERS_END();
+
+    uint32_t *column_ids = NULL;
+    size_t column_count = 0;
+    if (columns_ht != NULL && zend_hash_num_elements(columns_ht) > 0) {
+        column_count = zend_hash_num_elements(columns_ht);
+        column_ids = emalloc(column_count * sizeof(uint32_t));
+
+        size_t i = 0;
+        zval *entry;
+        ZEND_HASH_FOREACH_VAL(columns_ht, entry) {
+            column_ids[i++] = (uint32_t)zval_get_long(entry);
+        } ZEND_HASH_FOREACH_END();
+    }
+
+    size_t out_len = 0;
+    uint8_t* bytes = qail_encode_select_i((uint32_t)table_id, column_ids,
+                                          column_count, (int64_t)limit,
+                                          &out_len);
+    if (column_ids != NULL) {
+        efree(column_ids);
+    }
+
     if (bytes == NULL || out_len == 0) {
         RETURN_EMPTY_STRING();
     }
-    
+
+    RETVAL_STRINGL((const char*)bytes, out_len);
+    qail_bytes_free(bytes, out_len);
+}
+
+/* PHP function: qail_encode_query(string $table, string $columns,
+ *                                  array $where, array $params, int $limit)
+ *
+ * $where entries are "column" (implies =) or "column OP" specs; each is
+ * bound to the $params entry at the same position with its native zval
+ * type (long, double, string, bool, null), so filtered queries stay on
+ * the binary wire-protocol path in a single FFI call. */
+PHP_FUNCTION(qail_encode_query)
+{
+    char *table, *columns;
+    size_t table_len, columns_len;
+    HashTable *where_ht, *params_ht;
+    zend_long limit = 0;
+
+    ZEND_PARSE_PARAMETERS_START(4, 5)
+        Z_PARAM_STRING(table, table_len)
+        Z_PARAM_STRING(columns, columns_len)
+        Z_PARAM_ARRAY_HT(where_ht)
+        Z_PARAM_ARRAY_HT(params_ht)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(limit)
+    ZEND_PARSE_PARAMETERS_END();
+
+    size_t count = zend_hash_num_elements(where_ht);
+    if (count != zend_hash_num_elements(params_ht)) {
+        php_error_docref(NULL, E_WARNING, "where and params must have the same length");
+        RETURN_FALSE;
+    }
+
+    if (count == 0) {
+        /* No filters: same encoding as qail_encode_select */
+        size_t out_len = 0;
+        uint8_t* bytes = qail_encode_query(table, columns, NULL, NULL, NULL, NULL, NULL,
+                                           0, (int64_t)limit, &out_len);
+        if (bytes == NULL || out_len == 0) {
+            RETURN_EMPTY_STRING();
+        }
+        zend_string* result = zend_string_init((char*)bytes, out_len, 0);
+        qail_bytes_free(bytes, out_len);
+        RETURN_NEW_STR(result);
+    }
+
+    /* Marshal where specs and typed params into flat arrays */
+    const char** where_specs = emalloc(count * sizeof(char*));
+    uint8_t* param_types = emalloc(count * sizeof(uint8_t));
+    int64_t* param_longs = ecalloc(count, sizeof(int64_t));
+    double* param_doubles = ecalloc(count, sizeof(double));
+    const char** param_strings = ecalloc(count, sizeof(char*));
+
+    size_t i = 0;
+    zval* val;
+    int bad_input = 0;
+
+    ZEND_HASH_FOREACH_VAL(where_ht, val) {
+        if (Z_TYPE_P(val) != IS_STRING) {
+            bad_input = 1;
+            break;
+        }
+        where_specs[i++] = Z_STRVAL_P(val);
+    } ZEND_HASH_FOREACH_END();
+
+    i = 0;
+    if (!bad_input) {
+        ZEND_HASH_FOREACH_VAL(params_ht, val) {
+            switch (Z_TYPE_P(val)) {
+                case IS_NULL:
+                    param_types[i] = QAIL_PARAM_NULL;
+                    break;
+                case IS_LONG:
+                    param_types[i] = QAIL_PARAM_LONG;
+                    param_longs[i] = (int64_t)Z_LVAL_P(val);
+                    break;
+                case IS_DOUBLE:
+                    param_types[i] = QAIL_PARAM_DOUBLE;
+                    param_doubles[i] = Z_DVAL_P(val);
+                    break;
+                case IS_STRING:
+                    param_types[i] = QAIL_PARAM_STRING;
+                    param_strings[i] = Z_STRVAL_P(val);
+                    break;
+                case IS_TRUE:
+                case IS_FALSE:
+                    param_types[i] = QAIL_PARAM_BOOL;
+                    param_longs[i] = (Z_TYPE_P(val) == IS_TRUE) ? 1 : 0;
+                    break;
+                default:
+                    bad_input = 1;
+                    break;
+            }
+            if (bad_input) break;
+            i++;
+        } ZEND_HASH_FOREACH_END();
+    }
+
+    uint8_t* bytes = NULL;
+    size_t out_len = 0;
+    if (!bad_input) {
+        bytes = qail_encode_query(table, columns, where_specs, param_types,
+                                  param_longs, param_doubles, param_strings,
+                                  count, (int64_t)limit, &out_len);
+    }
+
+    efree(where_specs);
+    efree(param_types);
+    efree(param_longs);
+    efree(param_doubles);
+    efree(param_strings);
+
+    if (bad_input) {
+        php_error_docref(NULL, E_WARNING,
+                         "params must be long, double, string, bool or null");
+        RETURN_FALSE;
+    }
+
+    if (bytes == NULL || out_len == 0) {
+        RETURN_EMPTY_STRING();
+    }
+
     zend_string* result = zend_string_init((char*)bytes, out_len, 0);
     qail_bytes_free(bytes, out_len);
-    
+
     RETURN_NEW_STR(result);
 }
 
@@ -78,16 +714,26 @@ PHP_FUNCTION(qail_transpile)
         Z_PARAM_STRING(qail_text, qail_text_len)
     ZEND_PARSE_PARAMETERS_END();
     
+    /* Encode directly into the zend_string payload (see qail_encode_select) */
+    size_t cap = qail_text_len * 4 + 64;
+    zend_string* result = zend_string_alloc(cap, 0);
     size_t out_len = 0;
-    char* sql = qail_transpile(qail_text, &out_len);
-    
-    if (sql == NULL) {
+    int rc = qail_transpile_into(qail_text, (uint8_t*)ZSTR_VAL(result), cap, &out_len);
+    if (rc == 1) {
+        zend_string_release(result);
+        cap = out_len;
+        result = zend_string_alloc(cap, 0);
+        rc = qail_transpile_into(qail_text, (uint8_t*)ZSTR_VAL(result), cap, &out_len);
+    }
+
+    if (rc != 0) {
+        zend_string_release(result);
         RETURN_NULL();
     }
-    
-    zend_string* result = zend_string_init(sql, out_len, 0);
-    qail_string_free(sql);
-    
+
+    result = zend_string_truncate(result, out_len, 0);
+    ZSTR_VAL(result)[out_len] = '\0';
+
     RETURN_NEW_STR(result);
 }
 
@@ -118,19 +764,31 @@ PHP_FUNCTION(qail_encode_batch)
         limits[i++] = zval_get_long(val);
     } ZEND_HASH_FOREACH_END();
     
-    /* Call Rust batch encoder */
+    /* Batch output scales with count; encode directly into the
+     * zend_string payload (see qail_encode_select) */
+    size_t cap = 64 + count * 96;
+    zend_string* result = zend_string_alloc(cap, 0);
     size_t out_len = 0;
-    uint8_t* bytes = qail_encode_batch(table, columns, limits, count, &out_len);
-    
+    int rc = qail_encode_batch_into(table, columns, limits, count,
+                                    (uint8_t*)ZSTR_VAL(result), cap, &out_len);
+    if (rc == 1) {
+        zend_string_release(result);
+        cap = out_len;
+        result = zend_string_alloc(cap, 0);
+        rc = qail_encode_batch_into(table, columns, limits, count,
+                                    (uint8_t*)ZSTR_VAL(result), cap, &out_len);
+    }
+
     efree(limits);
-    
-    if (bytes == NULL || out_len == 0) {
+
+    if (rc != 0 || out_len == 0) {
+        zend_string_release(result);
         RETURN_EMPTY_STRING();
     }
-    
-    zend_string* result = zend_string_init((char*)bytes, out_len, 0);
-    qail_bytes_free(bytes, out_len);
-    
+
+    result = zend_string_truncate(result, out_len, 0);
+    ZSTR_VAL(result)[out_len] = '\0';
+
     RETURN_NEW_STR(result);
 }
 
@@ -138,11 +796,55 @@ PHP_FUNCTION(qail_encode_batch)
 static const zend_function_entry qail_functions[] = {
     PHP_FE(qail_version, NULL)
     PHP_FE(qail_encode_select, NULL)
+    PHP_FE(qail_intern, NULL)
+    PHP_FE(qail_encode_select_i, NULL)
+    PHP_FE(qail_encode_query, NULL)
     PHP_FE(qail_encode_batch, NULL)
     PHP_FE(qail_transpile, NULL)
+    PHP_FE(qail_stmt_encode, NULL)
+    PHP_FE(qail_stmt_cache_count, NULL)
+    PHP_FE(qail_stmt_cache_clear, NULL)
+    PHP_FE(qail_pconnect, NULL)
+    PHP_FE(qail_pclose, NULL)
+    PHP_FE(qail_pipeline_exec, NULL)
+    PHP_FE(qail_shm_stats, NULL)
+    PHP_FE(qail_batch_parallel_threshold, NULL)
     PHP_FE_END
 };
 
+/* Module init: set up the persistent statement cache and the shared
+ * memory segment (mapped before FPM forks, so workers share it) */
+PHP_MINIT_FUNCTION(qail)
+{
+    zend_hash_init(&qail_stmt_cache, 16, NULL, qail_stmt_entry_dtor, 1);
+
+    qail_shm = mmap(NULL, sizeof(qail_shm_seg), PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (qail_shm == MAP_FAILED) {
+        /* Per-worker caching still works without the shared segment */
+        qail_shm = NULL;
+    } else {
+        memset(qail_shm, 0, sizeof(qail_shm_seg));
+    }
+
+    return SUCCESS;
+}
+
+/* Module shutdown: release cached statements and the worker connection */
+PHP_MSHUTDOWN_FUNCTION(qail)
+{
+    zend_hash_destroy(&qail_stmt_cache);
+    if (qail_shm != NULL) {
+        munmap(qail_shm, sizeof(qail_shm_seg));
+        qail_shm = NULL;
+    }
+    if (qail_pconn != NULL) {
+        qail_disconnect(qail_pconn);
+        qail_pconn = NULL;
+    }
+    return SUCCESS;
+}
+
 /* Module info */
 PHP_MINFO_FUNCTION(qail)
 {
@@ -157,8 +859,8 @@ zend_module_entry qail_module_entry = {
     STANDARD_MODULE_HEADER,
     "qail",                     /* Extension name */
     qail_functions,             /* Function entries */
-    NULL,                       /* PHP_MINIT */
-    NULL,                       /* PHP_MSHUTDOWN */
+    PHP_MINIT(qail),            /* PHP_MINIT */
+    PHP_MSHUTDOWN(qail),        /* PHP_MSHUTDOWN */
     NULL,                       /* PHP_RINIT */
     NULL,                       /* PHP_RSHUTDOWN */
     PHP_MINFO(qail),            /* PHP_MINFO */
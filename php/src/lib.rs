@@ -35,6 +35,108 @@ pub struct QailPreparedStatement {
     sql: String,
 }
 
+// ==================== Interned Identifier Handles ====================
+// Table and column names never change at runtime, so callers intern each
+// identifier once at startup and pass u32 ids on the hot encode path.
+// The registry validates identifiers at intern time; steady-state encode
+// is index lookups with no C-string conversion, hashing, or splitting.
+
+struct InternRegistry {
+    names: Vec<String>,
+    index: std::collections::HashMap<String, u32>,
+}
+
+static INTERNED: Lazy<std::sync::RwLock<InternRegistry>> = Lazy::new(|| {
+    std::sync::RwLock::new(InternRegistry {
+        names: Vec::new(),
+        index: std::collections::HashMap::new(),
+    })
+});
+
+/// Intern an identifier (table or column name) and return its stable id.
+/// Interning the same name twice returns the same id. Ids start at 1;
+/// 0 is returned for NULL, empty, or invalid UTF-8 input.
+#[unsafe(no_mangle)]
+pub extern "C" fn qail_intern(name: *const c_char) -> u32 {
+    if name.is_null() {
+        return 0;
+    }
+    let name = match unsafe { CStr::from_ptr(name) }.to_str() {
+        Ok(s) if !s.trim().is_empty() => s.trim().to_string(),
+        _ => return 0,
+    };
+
+    let mut registry = INTERNED.write().unwrap();
+    if let Some(&id) = registry.index.get(&name) {
+        return id;
+    }
+    registry.names.push(name.clone());
+    let id = registry.names.len() as u32; // ids are 1-based
+    registry.index.insert(name, id);
+    id
+}
+
+/// Encode a SELECT query from pre-interned identifiers.
+/// `column_ids` may be NULL (or `column_count` 0) to select all columns.
+/// Returns NULL with *out_len = 0 if any id was never interned.
+/// Caller must free with qail_bytes_free().
+#[unsafe(no_mangle)]
+pub extern "C" fn qail_encode_select_i(
+    table_id: u32,
+    column_ids: *const u32,
+    column_count: usize,
+    limit: i64,
+    out_len: *mut usize,
+) -> *mut u8 {
+    let registry = INTERNED.read().unwrap();
+
+    let table = match table_id {
+        0 => None,
+        id => registry.names.get(id as usize - 1),
+    };
+    let Some(table) = table else {
+        unsafe {
+            *out_len = 0;
+        }
+        return std::ptr::null_mut();
+    };
+
+    let mut cmd = Qail::get(table);
+
+    if !column_ids.is_null() && column_count > 0 {
+        let ids = unsafe { std::slice::from_raw_parts(column_ids, column_count) };
+        let mut columns = Vec::with_capacity(column_count);
+        for &id in ids {
+            let name = match id {
+                0 => None,
+                id => registry.names.get(id as usize - 1),
+            };
+            let Some(name) = name else {
+                unsafe {
+                    *out_len = 0;
+                }
+                return std::ptr::null_mut();
+            };
+            columns.push(Expr::Named(name.clone()));
+        }
+        cmd.columns = columns;
+    }
+
+    if limit > 0 {
+        cmd = cmd.limit(limit);
+    }
+
+    let (wire_bytes, _params) = AstEncoder::encode_cmd(&cmd);
+    let bytes = wire_bytes.to_vec();
+
+    let len = bytes.len();
+    let ptr = Box::into_raw(bytes.into_boxed_slice()) as *mut u8;
+    unsafe {
+        *out_len = len;
+    }
+    ptr
+}
+
 // ==================== Encoding Functions (existing) ====================
 
 /// Encode a SELECT query to PostgreSQL wire protocol bytes.
@@ -126,8 +228,338 @@ pub extern "C" fn qail_encode_batch(
         cmds.push(cmd);
     }
 
-    let batch_bytes = AstEncoder::encode_batch(&cmds);
-    let bytes = batch_bytes.to_vec();
+    let bytes = encode_batch_bytes(&cmds);
+
+    let len = bytes.len();
+    let ptr = Box::into_raw(bytes.into_boxed_slice()) as *mut u8;
+    unsafe {
+        *out_len = len;
+    }
+    ptr
+}
+
+// ==================== Parallel Batch Encoding ====================
+
+/// Batch size at which encode_batch splits across worker threads.
+/// Below it, encoding stays on the calling thread; 0 disables
+/// parallelism entirely. Tunable via qail_batch_parallel_threshold().
+const BATCH_PARALLEL_DEFAULT: usize = 4096;
+static BATCH_PARALLEL_THRESHOLD: std::sync::atomic::AtomicUsize =
+    std::sync::atomic::AtomicUsize::new(BATCH_PARALLEL_DEFAULT);
+
+/// Set the batch size at which qail_encode_batch parallelizes.
+/// 0 keeps all encoding on the calling thread.
+#[unsafe(no_mangle)]
+pub extern "C" fn qail_batch_parallel_threshold(threshold: usize) {
+    BATCH_PARALLEL_THRESHOLD.store(threshold, std::sync::atomic::Ordering::Relaxed);
+}
+
+/// Postgres Sync message terminating every encode_batch buffer.
+const SYNC_MSG: [u8; 5] = [b'S', 0, 0, 0, 4];
+
+/// Encode a batch, splitting large inputs across threads.
+/// Each worker encodes a contiguous chunk of commands; the per-chunk
+/// trailing Sync messages are stripped and a single Sync is appended, so
+/// the output is byte-identical to the serial encoding and still one
+/// contiguous allocation.
+fn encode_batch_bytes(cmds: &[Qail]) -> Vec<u8> {
+    let threshold = BATCH_PARALLEL_THRESHOLD.load(std::sync::atomic::Ordering::Relaxed);
+    let workers = std::thread::available_parallelism()
+        .map(|n| n.get())
+        .unwrap_or(1);
+
+    if threshold == 0 || cmds.len() < threshold || workers <= 1 {
+        return AstEncoder::encode_batch(cmds).to_vec();
+    }
+
+    let chunk_size = cmds.len().div_ceil(workers);
+    let parts: Vec<Vec<u8>> = std::thread::scope(|scope| {
+        let handles: Vec<_> = cmds
+            .chunks(chunk_size)
+            .map(|chunk| {
+                scope.spawn(move || {
+                    let mut bytes = AstEncoder::encode_batch(chunk).to_vec();
+                    bytes.truncate(bytes.len() - SYNC_MSG.len());
+                    bytes
+                })
+            })
+            .collect();
+        handles.into_iter().map(|h| h.join().unwrap()).collect()
+    });
+
+    let total: usize = parts.iter().map(|p| p.len()).sum();
+    let mut out = Vec::with_capacity(total + SYNC_MSG.len());
+    for part in &parts {
+        out.extend_from_slice(part);
+    }
+    out.extend_from_slice(&SYNC_MSG);
+    out
+}
+
+// ==================== Caller-Buffer Encoding (zend_string direct) ====================
+//
+// The extension pre-allocates a zend_string and these _into variants
+// encode straight into its payload: no Rust-side Vec handoff, no
+// qail_bytes_free, and no copy from an intermediate allocation.
+
+/// Copy encoder output into a caller-supplied buffer.
+/// Returns 0 on success; 1 if cap is too small (out_len holds the
+/// required size so the caller can grow the buffer and retry).
+fn copy_into(src: &[u8], buf: *mut u8, cap: usize, out_len: *mut usize) -> i32 {
+    unsafe {
+        *out_len = src.len();
+    }
+    if buf.is_null() || cap < src.len() {
+        return 1;
+    }
+    unsafe {
+        std::ptr::copy_nonoverlapping(src.as_ptr(), buf, src.len());
+    }
+    0
+}
+
+/// Encode a SELECT query directly into a caller-supplied buffer.
+/// Same query semantics as qail_encode_select; buffer protocol as in
+/// copy_into. Returns -1 on invalid input.
+#[unsafe(no_mangle)]
+pub extern "C" fn qail_encode_select_into(
+    table: *const c_char,
+    columns: *const c_char,
+    limit: i64,
+    buf: *mut u8,
+    cap: usize,
+    out_len: *mut usize,
+) -> i32 {
+    if table.is_null() || out_len.is_null() {
+        return -1;
+    }
+
+    let table = unsafe { CStr::from_ptr(table).to_str().unwrap_or("") };
+    let columns_str = if columns.is_null() {
+        "*"
+    } else {
+        unsafe { CStr::from_ptr(columns).to_str().unwrap_or("*") }
+    };
+
+    let mut cmd = Qail::get(table);
+
+    if !columns_str.is_empty() && columns_str != "*" {
+        cmd.columns = columns_str
+            .split(',')
+            .map(|c| Expr::Named(c.trim().to_string()))
+            .collect();
+    }
+
+    if limit > 0 {
+        cmd = cmd.limit(limit);
+    }
+
+    let (wire_bytes, _params) = AstEncoder::encode_cmd(&cmd);
+    copy_into(&wire_bytes, buf, cap, out_len)
+}
+
+/// Encode a batch of SELECTs directly into a caller-supplied buffer.
+/// Same query semantics as qail_encode_batch; buffer protocol as in
+/// copy_into. Returns -1 on invalid input.
+#[unsafe(no_mangle)]
+pub extern "C" fn qail_encode_batch_into(
+    table: *const c_char,
+    columns: *const c_char,
+    limits: *const i64,
+    count: usize,
+    buf: *mut u8,
+    cap: usize,
+    out_len: *mut usize,
+) -> i32 {
+    if table.is_null() || limits.is_null() || count == 0 || out_len.is_null() {
+        return -1;
+    }
+
+    let table = unsafe { CStr::from_ptr(table).to_str().unwrap_or("") };
+    let columns_str = if columns.is_null() {
+        "*"
+    } else {
+        unsafe { CStr::from_ptr(columns).to_str().unwrap_or("*") }
+    };
+
+    let col_exprs: Vec<Expr> = if !columns_str.is_empty() && columns_str != "*" {
+        columns_str
+            .split(',')
+            .map(|c| Expr::Named(c.trim().to_string()))
+            .collect()
+    } else {
+        vec![]
+    };
+
+    let mut cmds = Vec::with_capacity(count);
+    for i in 0..count {
+        let limit = unsafe { *limits.add(i) };
+        let mut cmd = Qail::get(table);
+        cmd.columns = col_exprs.clone();
+        if limit > 0 {
+            cmd = cmd.limit(limit);
+        }
+        cmds.push(cmd);
+    }
+
+    let batch_bytes = encode_batch_bytes(&cmds);
+    copy_into(&batch_bytes, buf, cap, out_len)
+}
+
+/// Transpile QAIL text to SQL directly into a caller-supplied buffer.
+/// Buffer protocol as in copy_into. Returns -1 on invalid input or
+/// parse failure.
+#[unsafe(no_mangle)]
+pub extern "C" fn qail_transpile_into(
+    qail_text: *const c_char,
+    buf: *mut u8,
+    cap: usize,
+    out_len: *mut usize,
+) -> i32 {
+    if qail_text.is_null() || out_len.is_null() {
+        return -1;
+    }
+
+    let input = unsafe { CStr::from_ptr(qail_text).to_str().unwrap_or("") };
+
+    match qail_core::parse(input) {
+        Ok(cmd) => copy_into(cmd.to_sql().as_bytes(), buf, cap, out_len),
+        Err(_) => -1,
+    }
+}
+
+// Typed parameter tags shared with the PHP extension (zval types map
+// onto these when the extension marshals qail_encode_query arguments).
+const QAIL_PARAM_NULL: u8 = 0;
+const QAIL_PARAM_LONG: u8 = 1;
+const QAIL_PARAM_DOUBLE: u8 = 2;
+const QAIL_PARAM_STRING: u8 = 3;
+const QAIL_PARAM_BOOL: u8 = 4;
+
+fn operator_from_symbol(symbol: &str) -> Option<Operator> {
+    match symbol {
+        "=" => Some(Operator::Eq),
+        "!=" | "<>" => Some(Operator::Ne),
+        ">" => Some(Operator::Gt),
+        ">=" => Some(Operator::Gte),
+        "<" => Some(Operator::Lt),
+        "<=" => Some(Operator::Lte),
+        "like" | "LIKE" => Some(Operator::Like),
+        "ilike" | "ILIKE" => Some(Operator::ILike),
+        _ => None,
+    }
+}
+
+/// Encode a filtered SELECT with typed parameters to wire protocol bytes.
+/// Generalizes qail_encode_select: each WHERE spec is "column" (implies =)
+/// or "column OP", and the matching parameter is bound by type tag so
+/// filtered queries keep the string-free binary path.
+/// # Arguments
+/// * `table`, `columns` - as in qail_encode_select
+/// * `where_specs` - array of `where_count` condition specs
+/// * `param_types` - QAIL_PARAM_* tag per condition
+/// * `param_longs` / `param_doubles` / `param_strings` - value arrays;
+///   only the slot matching the tag is read for each condition
+/// * `limit` - row limit, 0 or negative for none
+/// Returns NULL on invalid input. Caller frees with qail_bytes_free().
+#[unsafe(no_mangle)]
+#[allow(clippy::too_many_arguments)]
+pub extern "C" fn qail_encode_query(
+    table: *const c_char,
+    columns: *const c_char,
+    where_specs: *const *const c_char,
+    param_types: *const u8,
+    param_longs: *const i64,
+    param_doubles: *const f64,
+    param_strings: *const *const c_char,
+    where_count: usize,
+    limit: i64,
+    out_len: *mut usize,
+) -> *mut u8 {
+    if table.is_null() || (where_count > 0 && (where_specs.is_null() || param_types.is_null())) {
+        unsafe {
+            *out_len = 0;
+        }
+        return std::ptr::null_mut();
+    }
+
+    let table = unsafe { CStr::from_ptr(table).to_str().unwrap_or("") };
+    let columns_str = if columns.is_null() {
+        "*"
+    } else {
+        unsafe { CStr::from_ptr(columns).to_str().unwrap_or("*") }
+    };
+
+    let mut cmd = Qail::get(table);
+
+    if !columns_str.is_empty() && columns_str != "*" {
+        cmd.columns = columns_str
+            .split(',')
+            .map(|c| Expr::Named(c.trim().to_string()))
+            .collect();
+    }
+
+    for i in 0..where_count {
+        let spec_ptr = unsafe { *where_specs.add(i) };
+        if spec_ptr.is_null() {
+            unsafe {
+                *out_len = 0;
+            }
+            return std::ptr::null_mut();
+        }
+        let spec = unsafe { CStr::from_ptr(spec_ptr).to_str().unwrap_or("") };
+
+        let (column, op) = match spec.split_once(' ') {
+            Some((column, symbol)) => match operator_from_symbol(symbol.trim()) {
+                Some(op) => (column.trim(), op),
+                None => {
+                    unsafe {
+                        *out_len = 0;
+                    }
+                    return std::ptr::null_mut();
+                }
+            },
+            None => (spec.trim(), Operator::Eq),
+        };
+
+        let value = match unsafe { *param_types.add(i) } {
+            QAIL_PARAM_NULL => Value::Null,
+            QAIL_PARAM_LONG if !param_longs.is_null() => {
+                Value::Int(unsafe { *param_longs.add(i) })
+            }
+            QAIL_PARAM_DOUBLE if !param_doubles.is_null() => {
+                Value::Float(unsafe { *param_doubles.add(i) })
+            }
+            QAIL_PARAM_STRING if !param_strings.is_null() => {
+                let s_ptr = unsafe { *param_strings.add(i) };
+                if s_ptr.is_null() {
+                    Value::Null
+                } else {
+                    Value::String(
+                        unsafe { CStr::from_ptr(s_ptr).to_str().unwrap_or("") }.to_string(),
+                    )
+                }
+            }
+            QAIL_PARAM_BOOL if !param_longs.is_null() => {
+                Value::Bool(unsafe { *param_longs.add(i) } != 0)
+            }
+            _ => {
+                unsafe {
+                    *out_len = 0;
+                }
+                return std::ptr::null_mut();
+            }
+        };
+
+        cmd = cmd.filter(column, op, value);
+    }
+
+    if limit > 0 {
+        cmd = cmd.limit(limit);
+    }
+
+    let (wire_bytes, _params) = AstEncoder::encode_cmd(&cmd);
+    let bytes = wire_bytes.to_vec();
 
     let len = bytes.len();
     let ptr = Box::into_raw(bytes.into_boxed_slice()) as *mut u8;
@@ -474,6 +906,38 @@ pub extern "C" fn qail_pipeline_exec_limits(
     }
 }
 
+/// Execute pre-encoded extended-protocol wire bytes on a connection.
+/// The whole batch (e.g. output of qail_encode_batch) is written in one
+/// flush and all responses are consumed in Rust, so N queries cost one
+/// round-trip and zero userland socket work.
+/// Returns the number of completed queries, or -1 on failure.
+#[unsafe(no_mangle)]
+pub extern "C" fn qail_exec_encoded(
+    conn: *mut QailConnection,
+    bytes: *const u8,
+    len: usize,
+    expected_queries: usize,
+) -> i64 {
+    if conn.is_null() || bytes.is_null() || len == 0 || expected_queries == 0 {
+        return -1;
+    }
+
+    let conn_ref = unsafe { &*conn };
+    let wire_bytes = unsafe { std::slice::from_raw_parts(bytes, len) };
+
+    let result = RUNTIME.block_on(async {
+        let mut conn_guard = conn_ref.inner.lock().await;
+        conn_guard
+            .pipeline_bytes_fast(wire_bytes, expected_queries)
+            .await
+    });
+
+    match result {
+        Ok(count) => count as i64,
+        Err(_) => -1,
+    }
+}
+
 // ==================== Streaming COPY FFI ====================
 
 /// Handle for streaming COPY operation.